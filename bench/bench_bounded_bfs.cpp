@@ -0,0 +1,79 @@
+/*
+ * startup latency of the distance table, lazy BFS vs bounded BFS
+ * first step: distances of all agents at their starts and neighbors
+ * usage: bench_bounded_bfs [width of empty grid] [N] [time limit ms]
+ */
+#include <filesystem>
+#include <lacam2.hpp>
+
+int main(int argc, char* argv[])
+{
+  const int width = argc > 1 ? std::stoi(argv[1]) : 1024;
+  const uint N = argc > 2 ? std::stoi(argv[2]) : 200;
+  const double time_limit_ms = argc > 3 ? std::stod(argv[3]) : 30000;
+
+  // empty grid
+  const auto map_filename =
+      (std::filesystem::temp_directory_path() / "lacam2_bench_bounded.map")
+          .string();
+  {
+    std::ofstream file(map_filename);
+    file << "type octile\nheight " << width << "\nwidth " << width << "\nmap\n";
+    for (auto y = 0; y < width; ++y) file << std::string(width, '.') << "\n";
+  }
+  auto MT = std::mt19937(0);
+  const auto ins = Instance(map_filename, &MT, N);
+  std::filesystem::remove(map_filename);
+
+  struct Setting {
+    DistMode mode;
+    uint radius;
+    uint budget;
+  };
+  const std::vector<Setting> settings = {
+      {DIST_BFS, 0, 0},         {DIST_BOUNDED, 0, 16},
+      {DIST_BOUNDED, 0, 256},   {DIST_BOUNDED, 16, 64},
+      {DIST_BOUNDED, 64, 1024},
+  };
+
+  for (auto& s : settings) {
+    auto options = PlannerOptions();
+    options.dist.mode = s.mode;
+    options.dist.bfs_radius = s.radius;
+    options.dist.bfs_budget = s.budget;
+
+    const auto t_first = Deadline();
+    uint64_t sum = 0;
+    {
+      auto D = DistTable(ins, options.dist);
+      for (uint i = 0; i < N; ++i) {
+        sum += D.get(i, ins.starts[i]);
+        for (auto u : ins.starts[i]->neighbor) sum += D.get(i, u);
+      }
+    }
+    const auto time_first = t_first.elapsed_ns() / 1e6;
+
+    auto MT_s = std::mt19937(0);
+    const auto deadline = Deadline(time_limit_ms);
+    auto planner = Planner(&ins, &deadline, &MT_s, 0, OBJ_NONE, 0.001,
+                           nullptr, options);
+    auto additional_info = std::string();
+    const auto solution = planner.solve(additional_info);
+    const auto time_solve = deadline.elapsed_ms();
+
+    std::cout << std::setw(8) << s.mode;
+    if (s.mode == DIST_BOUNDED) {
+      std::cout << " r=" << std::setw(4) << s.radius << " budget="
+                << std::setw(5) << s.budget;
+    } else {
+      std::cout << std::string(19, ' ');
+    }
+    std::cout << "  first step: " << std::setw(8) << time_first << "ms"
+              << "  solve: " << std::setw(6) << time_solve << "ms"
+              << "  lower bounds: " << std::setw(8)
+              << planner.D.num_lower_bounds << "  soc: "
+              << (solution.empty() ? -1 : get_sum_of_costs(solution))
+              << "  checksum=" << sum << std::endl;
+  }
+  return 0;
+}
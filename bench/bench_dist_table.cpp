@@ -0,0 +1,70 @@
+/*
+ * distance table backends: lazy BFS vs landmarks
+ * reports memory, init time, solve time and solution quality
+ * usage: bench_dist_table [map] [scen] [N] [time limit ms]
+ */
+#include <lacam2.hpp>
+
+int main(int argc, char* argv[])
+{
+  const std::string map_filename =
+      argc > 1 ? argv[1] : "./assets/random-32-32-10.map";
+  const std::string scen_filename =
+      argc > 2 ? argv[2] : "./assets/random-32-32-10-random-1.scen";
+  const uint N = argc > 3 ? std::stoi(argv[3]) : 200;
+  const double time_limit_ms = argc > 4 ? std::stod(argv[4]) : 10000;
+  const auto ins = Instance(scen_filename, map_filename, N);
+
+  struct Setting {
+    DistMode mode;
+    uint num_landmarks;
+    LandmarkSelection selection;
+    uint radius;
+  };
+  const std::vector<Setting> settings = {
+      {DIST_BFS, 0, LANDMARK_FARTHEST, 0},
+      {DIST_LANDMARK, 4, LANDMARK_FARTHEST, 8},
+      {DIST_LANDMARK, 16, LANDMARK_RANDOM, 8},
+      {DIST_LANDMARK, 16, LANDMARK_FARTHEST, 8},
+      {DIST_LANDMARK, 16, LANDMARK_FARTHEST, 16},
+      {DIST_LANDMARK, 64, LANDMARK_FARTHEST, 8},
+  };
+
+  for (auto& s : settings) {
+    auto options = PlannerOptions();
+    options.dist.mode = s.mode;
+    options.dist.num_landmarks = s.num_landmarks;
+    options.dist.landmark_selection = s.selection;
+    options.dist.landmark_radius = s.radius;
+
+    const auto t_init = Deadline();
+    { auto D = DistTable(ins, options.dist); }
+    const auto time_init = t_init.elapsed_ns() / 1e6;
+
+    auto MT = std::mt19937(0);
+    const auto deadline = Deadline(time_limit_ms);
+    auto planner = Planner(&ins, &deadline, &MT, 0, OBJ_NONE, 0.001, nullptr,
+                           options);
+    auto additional_info = std::string();
+    const auto solution = planner.solve(additional_info);
+    const auto time_solve = deadline.elapsed_ms();
+
+    std::cout << std::setw(8) << s.mode;
+    if (s.mode == DIST_LANDMARK) {
+      std::cout << " K=" << std::setw(2) << s.num_landmarks << " "
+                << std::setw(8) << s.selection << " r=" << std::setw(2)
+                << s.radius;
+    } else {
+      std::cout << std::string(22, ' ');
+    }
+    std::cout << "  memory: " << std::setw(8)
+              << planner.D.memory_usage() / 1024 << "KB"
+              << "  init: " << std::setw(7) << time_init << "ms"
+              << "  solve: " << std::setw(6) << time_solve << "ms"
+              << "  loops: " << std::setw(7) << planner.loop_cnt
+              << "  soc: "
+              << (solution.empty() ? -1 : get_sum_of_costs(solution))
+              << std::endl;
+  }
+  return 0;
+}
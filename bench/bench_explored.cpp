@@ -0,0 +1,74 @@
+/*
+ * lookup throughput of the explored set, single vs batched probes
+ * usage: bench_explored [#stored configurations] [N] [batch size]
+ */
+#include <lacam2.hpp>
+
+struct Key {
+  const Config C;
+};
+
+int main(int argc, char* argv[])
+{
+  const size_t num_stored = argc > 1 ? std::stoul(argv[1]) : 10000000;
+  const uint N = argc > 2 ? std::stoi(argv[2]) : 4;
+  const size_t batch_size = argc > 3 ? std::stoul(argv[3]) : 8;
+  const size_t num_queries = 4000000;
+
+  const auto G = Graph("./assets/random-32-32-10.map");
+  auto MT = std::mt19937(0);
+  auto random_config = [&]() {
+    auto C = Config(N, nullptr);
+    for (auto& v : C) v = G.V[get_random_int(&MT, 0, G.size() - 1)];
+    return C;
+  };
+
+  // setup
+  const auto t_setup = Deadline();
+  auto keys = std::vector<Key*>();
+  auto EXPLORED = Explored<Key>();
+  while (EXPLORED.size() < num_stored) {
+    auto key = new Key{random_config()};
+    if (EXPLORED.find(key->C) != nullptr) {
+      delete key;
+      continue;
+    }
+    keys.push_back(key);
+    EXPLORED.insert(key);
+  }
+  std::cout << "stored " << EXPLORED.size() << " configurations in "
+            << t_setup.elapsed_ms() << "ms" << std::endl;
+
+  // queries, half of them are stored ones
+  auto queries = std::vector<Config>();
+  for (size_t k = 0; k < num_queries; ++k) {
+    queries.push_back(k % 2 == 0 ? keys[get_random_int(&MT, 0, keys.size() - 1)]->C
+                                 : random_config());
+  }
+
+  size_t found = 0;
+  const auto t_single = Deadline();
+  for (auto& C : queries) found += EXPLORED.find(C) != nullptr;
+  const auto time_single = t_single.elapsed_ns() / num_queries;
+  std::cout << "single:  " << time_single << " ns/query, found=" << found
+            << std::endl;
+
+  found = 0;
+  auto Cs = std::vector<const Config*>();
+  auto hashes = std::vector<uint>();
+  auto res = std::vector<Key*>();
+  const auto t_batch = Deadline();
+  for (size_t k = 0; k < num_queries; k += batch_size) {
+    Cs.clear();
+    for (size_t j = k; j < std::min(k + batch_size, num_queries); ++j)
+      Cs.push_back(&queries[j]);
+    EXPLORED.find_batch(Cs, hashes, res);
+    for (auto r : res) found += r != nullptr;
+  }
+  const auto time_batch = t_batch.elapsed_ns() / num_queries;
+  std::cout << "batched: " << time_batch << " ns/query, found=" << found
+            << " (batch size " << batch_size << ")" << std::endl;
+
+  for (auto key : keys) delete key;
+  return 0;
+}
@@ -0,0 +1,98 @@
+/*
+ * random lookups of a large distance table, default pages vs huge pages
+ * reports runtime, dTLB load misses (if perf events are available) and
+ * the amount of memory backed by transparent huge pages
+ * usage: bench_huge_pages [width of empty grid] [N] [#queries]
+ */
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <lacam2.hpp>
+
+// -1 when perf events are not permitted
+static int open_dtlb_counter()
+{
+  perf_event_attr attr{};
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HW_CACHE;
+  attr.config = PERF_COUNT_HW_CACHE_DTLB |
+                (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  return syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+static long get_anon_huge_kb()
+{
+  std::ifstream file("/proc/self/smaps_rollup");
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.rfind("AnonHugePages:", 0) == 0) return std::stol(line.substr(14));
+  }
+  return -1;
+}
+
+int main(int argc, char* argv[])
+{
+  const int width = argc > 1 ? std::stoi(argv[1]) : 512;
+  const uint N = argc > 2 ? std::stoi(argv[2]) : 1000;
+  const size_t num_queries = argc > 3 ? std::stoul(argv[3]) : 20000000;
+
+  // empty grid
+  const auto map_filename =
+      (std::filesystem::temp_directory_path() / "lacam2_bench_huge.map")
+          .string();
+  {
+    std::ofstream file(map_filename);
+    file << "type octile\nheight " << width << "\nwidth " << width << "\nmap\n";
+    for (auto y = 0; y < width; ++y) file << std::string(width, '.') << "\n";
+  }
+  auto MT = std::mt19937(0);
+  const auto ins = Instance(map_filename, &MT, N);
+  std::filesystem::remove(map_filename);
+  std::cout << "table: " << ((size_t)N * ins.G.size() * sizeof(uint) >> 20)
+            << "MB" << std::endl;
+
+  const auto fd = open_dtlb_counter();
+  for (auto enabled : {false, true}) {
+    auto options = DistOptions();
+    options.huge_pages = enabled;
+    auto D = DistTable(ins, options);
+    auto pool = ThreadPool(std::thread::hardware_concurrency());
+    D.setup_all(&pool);
+
+    // queries are generated beforehand
+    auto MT_q = std::mt19937(1);
+    auto queries = std::vector<std::pair<uint, Vertex*> >(num_queries);
+    for (auto& q : queries) {
+      q = {get_random_int(&MT_q, 0, N - 1),
+           ins.G.V[get_random_int(&MT_q, 0, ins.G.size() - 1)]};
+    }
+
+    if (fd >= 0) {
+      ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+      ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+    const auto t = Deadline();
+    uint64_t sum = 0;
+    for (auto& q : queries) sum += D.get(q.first, q.second);
+    const auto time_ns = t.elapsed_ns() / num_queries;
+    long long misses = -1;
+    if (fd >= 0) {
+      ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+      if (read(fd, &misses, sizeof(misses)) != sizeof(misses)) misses = -1;
+    }
+
+    std::cout << (enabled ? "huge:    " : "default: ") << time_ns
+              << " ns/query, dTLB misses: "
+              << (misses >= 0 ? std::to_string(misses) : std::string("n/a"))
+              << ", AnonHugePages: " << get_anon_huge_kb() << "kB"
+              << ", checksum=" << sum << std::endl;
+  }
+  if (fd >= 0) close(fd);
+  return 0;
+}
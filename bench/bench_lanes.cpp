@@ -0,0 +1,88 @@
+/*
+ * warehouse-like grid, bidirectional aisles vs one-way lanes
+ * interior aisles alternate directions, the outer ring stays bidirectional
+ * usage: bench_lanes [#blocks x] [#blocks y] [N] [#instances] [time limit ms]
+ */
+#include <filesystem>
+#include <lacam2.hpp>
+
+// aisles every 3 rows and 4 columns, shelves in between
+static std::string write_map(const int bx, const int by, const bool lanes)
+{
+  const auto width = 4 * bx + 1;
+  const auto height = 3 * by + 1;
+  const auto filename =
+      (std::filesystem::temp_directory_path() /
+       (std::string("lacam2_bench_lanes_") + (lanes ? "1" : "0") + ".map"))
+          .string();
+  std::ofstream file(filename);
+  file << "type octile\nheight " << height << "\nwidth " << width << "\nmap\n";
+  for (auto y = 0; y < height; ++y) {
+    for (auto x = 0; x < width; ++x) {
+      const auto row = y % 3 == 0;
+      const auto col = x % 4 == 0;
+      const auto border = x == 0 || y == 0 || x == width - 1 || y == height - 1;
+      if (!row && !col) {
+        file << '@';
+      } else if (!lanes || border || (row && col)) {
+        file << '.';
+      } else if (row) {
+        file << ((y / 3) % 2 == 0 ? '>' : '<');
+      } else {
+        file << ((x / 4) % 2 == 0 ? 'v' : '^');
+      }
+    }
+    file << "\n";
+  }
+  return filename;
+}
+
+int main(int argc, char* argv[])
+{
+  const int bx = argc > 1 ? std::stoi(argv[1]) : 12;
+  const int by = argc > 2 ? std::stoi(argv[2]) : 12;
+  const uint N = argc > 3 ? std::stoi(argv[3]) : 100;
+  const int num_instances = argc > 4 ? std::stoi(argv[4]) : 5;
+  const double time_limit_ms = argc > 5 ? std::stod(argv[5]) : 5000;
+
+  auto options = PlannerOptions();
+  options.pibt_stats = true;
+  for (auto lanes : {false, true}) {
+    const auto map_filename = write_map(bx, by, lanes);
+    int solved = 0;
+    double time_sum = 0;
+    uint64_t soc_sum = 0, loop_sum = 0;
+    for (auto k = 0; k < num_instances; ++k) {
+      auto MT = std::mt19937(k);
+      const auto ins = Instance(map_filename, &MT, N);
+      if (!ins.is_valid()) continue;
+      auto additional_info = std::string();
+      const auto deadline = Deadline(time_limit_ms);
+      auto planner = Planner(&ins, &deadline, &MT, 0, OBJ_NONE, 0.001,
+                             nullptr, options);
+      const auto solution = planner.solve(additional_info);
+      time_sum += deadline.elapsed_ms();
+      loop_sum += planner.loop_cnt;
+      if (solution.empty() || !is_feasible_solution(ins, solution)) continue;
+      ++solved;
+      soc_sum += get_sum_of_costs(solution);
+      if (k == 0) {
+        std::cout << (lanes ? "lanes" : "free ") << " instance 0: "
+                  << "fail_rate="
+                  << (double)(planner.workers[0]->stats.num_fail_constraints +
+                              planner.workers[0]->stats.num_fail_pibt) /
+                         std::max(planner.workers[0]->stats.num_calls,
+                                  (uint64_t)1)
+                  << " chain_depth_mean="
+                  << planner.workers[0]->stats.chain_depth.mean()
+                  << std::endl;
+      }
+    }
+    std::filesystem::remove(map_filename);
+    std::cout << (lanes ? "lanes" : "free ") << ": solved " << solved << "/"
+              << num_instances << ", time " << time_sum / num_instances
+              << " ms/instance, loops " << loop_sum / num_instances
+              << ", soc " << (solved > 0 ? soc_sum / solved : 0) << std::endl;
+  }
+  return 0;
+}
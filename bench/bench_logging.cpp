@@ -0,0 +1,39 @@
+/*
+ * cost of info() on the caller, synchronous vs asynchronous writes
+ * usage: bench_logging [lines] [log file]
+ */
+#include <lacam2.hpp>
+
+int main(int argc, char* argv[])
+{
+  const int num_lines = argc > 1 ? std::stoi(argv[1]) : 200000;
+  const std::string filename = argc > 2 ? argv[2] : "/dev/null";
+  Logger::clear_sinks();
+  if (!Logger::add_file_sink(filename)) return 1;
+
+  auto Vs = std::vector<uint>({3, 14, 15, 92});
+  auto bench = [&]() {
+    const auto deadline = Deadline();
+    for (int i = 0; i < num_lines; ++i) {
+      info(0, 0, "elapsed:", std::setw(6), i, "ms  loop_cnt:", std::setw(8),
+           i * 7, "  node_cnt:", std::setw(8), i * 3,
+           "\tfound solution, cost: ", Vs[i % 4]);
+    }
+    const auto caller_ns = deadline.elapsed_ns();
+    Logger::flush();
+    return std::make_pair(caller_ns / num_lines, deadline.elapsed_ms());
+  };
+
+  const auto [sync_ns, sync_ms] = bench();
+  Logger::start();
+  const auto [async_ns, async_ms] = bench();
+  Logger::stop();
+  Logger::clear_sinks();
+  Logger::add_stdout_sink();
+  info(0, 0, "lines=", num_lines, ", sink=", filename);
+  info(0, 0, "sync:  ", sync_ns, " ns/line on the caller, total ", sync_ms,
+       " ms");
+  info(0, 0, "async: ", async_ns, " ns/line on the caller, total ", async_ms,
+       " ms (incl. flush)");
+  return 0;
+}
@@ -0,0 +1,71 @@
+/*
+ * scaling of the distance table over threads, with and without NUMA placement
+ * each worker looks up rows assigned to its own node
+ * usage: bench_numa [width of empty grid] [N] [#queries per thread]
+ */
+#include <filesystem>
+#include <lacam2.hpp>
+
+int main(int argc, char* argv[])
+{
+  const int width = argc > 1 ? std::stoi(argv[1]) : 256;
+  const uint N = argc > 2 ? std::stoi(argv[2]) : 1000;
+  const size_t num_queries = argc > 3 ? std::stoul(argv[3]) : 5000000;
+
+  // empty grid
+  const auto map_filename =
+      (std::filesystem::temp_directory_path() / "lacam2_bench_numa.map")
+          .string();
+  {
+    std::ofstream file(map_filename);
+    file << "type octile\nheight " << width << "\nwidth " << width << "\nmap\n";
+    for (auto y = 0; y < width; ++y) file << std::string(width, '.') << "\n";
+  }
+  auto MT = std::mt19937(0);
+  const auto ins = Instance(map_filename, &MT, N);
+  std::filesystem::remove(map_filename);
+
+  const auto num_nodes = Numa::num_nodes();
+  const auto max_threads = std::max(std::thread::hardware_concurrency(), 1u);
+  std::cout << "nodes: " << num_nodes << ", table: "
+            << ((size_t)N * ins.G.size() * sizeof(uint) >> 20) << "MB"
+            << std::endl;
+
+  for (size_t num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+    for (auto enabled : {false, true}) {
+      auto options = DistOptions();
+      options.numa = enabled;
+      auto pool = ThreadPool(num_threads);
+      auto D = DistTable(ins, options);
+      const auto t_fill = Deadline();
+      D.setup_all(&pool);
+      const auto time_fill = t_fill.elapsed_ms();
+
+      // rows of the worker's node
+      auto rows = std::vector<std::vector<uint> >(num_nodes);
+      for (uint i = 0; i < N; ++i) rows[D.get_row_node(i)].push_back(i);
+      auto sums = std::vector<uint64_t>(num_threads, 0);
+      const auto t_query = Deadline();
+      pool.run_each([&](size_t k) {
+        const auto& my_rows = rows[enabled ? Numa::node_of_worker(k) : 0];
+        auto MT_q = std::mt19937(k);
+        uint64_t sum = 0;
+        for (size_t q = 0; q < num_queries; ++q) {
+          const auto i = my_rows[get_random_int(&MT_q, 0, my_rows.size() - 1)];
+          sum += D.get(i, ins.G.V[get_random_int(&MT_q, 0, ins.G.size() - 1)]);
+        }
+        sums[k] = sum;
+      });
+      const auto time_query = t_query.elapsed_ms();
+
+      std::cout << "threads=" << num_threads << " numa=" << enabled
+                << " fill: " << time_fill << "ms, lookups: "
+                << num_queries * num_threads / std::max(time_query, 1.0) / 1000
+                << " M/s, row 0 on node " << Numa::node_of_address(D.table.data())
+                << ", checksum=" << std::accumulate(sums.begin(), sums.end(),
+                                                    (uint64_t)0)
+                << std::endl;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,50 @@
+/*
+ * scaling of batched parallel low-level expansion, experimental (--threads)
+ * the search differs from the sequential mode; compare nodes/sec only
+ * usage: bench_parallel_expansion [map] [N] [#seeds] [time_limit_sec] [max_threads]
+ */
+#include <lacam2.hpp>
+
+int main(int argc, char* argv[])
+{
+  const std::string map_name =
+      argc > 1 ? argv[1] : "./assets/random-32-32-10.map";
+  const uint N = argc > 2 ? std::stoi(argv[2]) : 600;
+  const int num_seeds = argc > 3 ? std::stoi(argv[3]) : 5;
+  const int time_limit_sec = argc > 4 ? std::stoi(argv[4]) : 30;
+  const uint max_threads = argc > 5 ? std::stoi(argv[5])
+                                    : std::max(std::thread::hardware_concurrency(), 1u);
+
+  std::cout << "threads\tseed\tsolved\tloop_cnt\tnode_cnt\tcomp_time_ms\tnodes/sec"
+            << std::endl;
+  for (uint threads = 1; threads <= max_threads; threads *= 2) {
+    auto options = PlannerOptions();
+    options.num_threads = threads;
+    int solved = 0;
+    double sum_nodes = 0, sum_time = 0;
+    for (int seed = 0; seed < num_seeds; ++seed) {
+      auto MT = std::mt19937(seed);
+      const auto ins = Instance(map_name, &MT, N);
+      if (!ins.is_valid(1)) return 1;
+      auto additional_info = std::string("");
+      HNode::HNODE_CNT = 0;
+      const auto deadline = Deadline(time_limit_sec * 1000);
+      auto planner = Planner(&ins, &deadline, &MT, 0, OBJ_NONE, 0.001,
+                             nullptr, options);
+      const auto solution = planner.solve(additional_info);
+      const auto comp_time_ms = deadline.elapsed_ms();
+      solved += !solution.empty();
+      sum_nodes += HNode::HNODE_CNT;
+      sum_time += comp_time_ms;
+      std::cout << threads << "\t" << seed << "\t" << !solution.empty() << "\t"
+                << planner.loop_cnt << "\t" << HNode::HNODE_CNT << "\t"
+                << comp_time_ms << "\t"
+                << HNode::HNODE_CNT / std::max(comp_time_ms, 1.0) * 1000
+                << std::endl;
+    }
+    std::cout << "# threads=" << threads << ": solved " << solved << "/"
+              << num_seeds << ", nodes/sec=" << sum_nodes / sum_time * 1000
+              << ", comp_time_ms(avg)=" << sum_time / num_seeds << std::endl;
+  }
+  return 0;
+}
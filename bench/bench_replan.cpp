@@ -0,0 +1,77 @@
+/*
+ * replanning k agents against fixed paths vs solving from scratch
+ * usage: bench_replan [map] [scen] [N] [time limit ms]
+ */
+#include <lacam2.hpp>
+
+int main(int argc, char* argv[])
+{
+  const std::string map_filename =
+      argc > 1 ? argv[1] : "./assets/random-32-32-10.map";
+  const std::string scen_filename =
+      argc > 2 ? argv[2] : "./assets/random-32-32-10-random-1.scen";
+  const uint N = argc > 3 ? std::stoi(argv[3]) : 200;
+  const double time_limit_ms = argc > 4 ? std::stod(argv[4]) : 10000;
+  const auto ins = Instance(scen_filename, map_filename, N);
+  auto MT = std::mt19937(0);
+  auto additional_info = std::string();
+  const auto solution = solve(ins, additional_info, 0, nullptr, &MT);
+  std::cout << "N=" << ins.N << ", makespan=" << get_makespan(solution)
+            << std::endl;
+
+  const int num_trials = 10;
+  for (uint k : {1, 5, 20}) {
+    int num_solved = 0, num_full_solved = 0;
+    double time_replan = 0, time_full = 0;
+    for (int trial = 0; trial < num_trials; ++trial) {
+      // k agents with new goals, unused by others
+      auto agents = std::vector<uint>(ins.N);
+      std::iota(agents.begin(), agents.end(), 0);
+      std::shuffle(agents.begin(), agents.end(), MT);
+      agents.resize(k);
+      auto used = std::vector<bool>(ins.G.size(), false);
+      for (auto v : ins.goals) used[v->id] = true;
+      auto new_goals = Config();
+      while (new_goals.size() < k) {
+        auto v = ins.G.V[get_random_int(&MT, 0, ins.G.size() - 1)];
+        if (used[v->id]) continue;
+        used[v->id] = true;
+        new_goals.push_back(v);
+      }
+      auto start_indexes = std::vector<uint>();
+      auto goal_indexes = std::vector<uint>();
+      for (uint i = 0; i < ins.N; ++i) {
+        start_indexes.push_back(ins.starts[i]->index);
+        goal_indexes.push_back(ins.goals[i]->index);
+      }
+      for (size_t j = 0; j < k; ++j) {
+        goal_indexes[agents[j]] = new_goals[j]->index;
+      }
+      const auto ins_new = Instance(map_filename, start_indexes, goal_indexes);
+
+      const auto t_replan = Deadline(time_limit_ms);
+      const auto merged = replan(ins, solution, agents, new_goals, &t_replan);
+      time_replan += t_replan.elapsed_ms();
+      if (!merged.empty()) {
+        if (!is_feasible_solution(ins_new, merged)) {
+          std::cout << "invalid solution" << std::endl;
+          return 1;
+        }
+        ++num_solved;
+      }
+
+      // from scratch
+      auto MT_s = std::mt19937(0);
+      const auto t_full = Deadline(time_limit_ms);
+      const auto full = solve(ins_new, additional_info, 0, &t_full, &MT_s);
+      time_full += t_full.elapsed_ms();
+      num_full_solved += !full.empty();
+    }
+    std::cout << "k=" << std::setw(2) << k << "  replan: " << std::setw(6)
+              << time_replan / num_trials << "ms, solved " << num_solved << "/"
+              << num_trials << "  full: " << std::setw(6)
+              << time_full / num_trials << "ms, solved " << num_full_solved
+              << "/" << num_trials << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,102 @@
+/*
+ * solution handoff to a client: text and binary over a pipe vs shared memory
+ * the client touches every entry (checksum) in all cases
+ * usage: bench_shm_handoff [N] [T]
+ */
+#include <unistd.h>
+
+#include <filesystem>
+#include <lacam2.hpp>
+
+int main(int argc, char* argv[])
+{
+  const uint N = argc > 1 ? std::stoi(argv[1]) : 10000;
+  const uint T = argc > 2 ? std::stoi(argv[2]) : 1000;
+  const int width = 256;
+
+  // empty grid, random walks are enough here
+  const auto map_filename =
+      (std::filesystem::temp_directory_path() / "lacam2_bench_shm.map")
+          .string();
+  {
+    std::ofstream file(map_filename);
+    file << "type octile\nheight " << width << "\nwidth " << width << "\nmap\n";
+    for (auto y = 0; y < width; ++y) file << std::string(width, '.') << "\n";
+  }
+  auto MT = std::mt19937(0);
+  const auto ins = Instance(map_filename, &MT, N);
+  std::filesystem::remove(map_filename);
+  auto solution = Solution(T, ins.starts);
+  for (uint t = 1; t < T; ++t) {
+    for (uint i = 0; i < N; ++i) {
+      const auto& C = solution[t - 1][i]->neighbor;
+      solution[t][i] = C[get_random_int(&MT, 0, C.size() - 1)];
+    }
+  }
+  std::cout << "N=" << N << " T=" << T << ", "
+            << ((size_t)N * T * sizeof(uint32_t) >> 20) << "MB as uint32"
+            << std::endl;
+
+  auto pipe_handoff = [&](const bool text) {
+    int fds[2];
+    if (pipe(fds) != 0) return -1.0;
+    uint64_t sum = 0;
+    const auto t_start = Deadline();
+    auto client = std::thread([&]() {
+      auto buf = std::vector<char>(1 << 16);
+      ssize_t n;
+      while ((n = read(fds[0], buf.data(), buf.size())) > 0) {
+        for (ssize_t k = 0; k < n; ++k) sum += (unsigned char)buf[k];
+      }
+    });
+    auto out = std::string();
+    for (auto& C : solution) {
+      out.clear();
+      if (text) {
+        for (auto v : C) {
+          out += "(" + std::to_string(v->index % width) + "," +
+                 std::to_string(v->index / width) + "),";
+        }
+        out += "\n";
+      } else {
+        for (auto v : C) out.append((const char*)&v->index, sizeof(uint32_t));
+      }
+      for (size_t w = 0; w < out.size();) {
+        const auto res = write(fds[1], out.data() + w, out.size() - w);
+        if (res <= 0) break;
+        w += res;
+      }
+    }
+    close(fds[1]);
+    client.join();
+    close(fds[0]);
+    std::cout << "checksum=" << sum << "  ";
+    return t_start.elapsed_ms();
+  };
+
+  auto shm_handoff = [&]() {
+    const auto name = "/lacam2_bench_" + std::to_string(getpid());
+    uint64_t sum = 0;
+    const auto t_start = Deadline();
+    auto client = std::thread([&]() {
+      auto shm = ShmSegment(name);
+      if (!shm.wait()) return;
+      const auto data = shm.data();
+      const size_t size = (size_t)shm.header()->N * shm.header()->T;
+      for (size_t k = 0; k < size; ++k) sum += data[k];
+      shm.unlink();
+    });
+    {
+      auto shm = ShmSegment(name);
+      shm.publish(ins, solution, 0);
+    }
+    client.join();
+    std::cout << "checksum=" << sum << "  ";
+    return t_start.elapsed_ms();
+  };
+
+  std::cout << "pipe, text:   " << pipe_handoff(true) << "ms" << std::endl;
+  std::cout << "pipe, binary: " << pipe_handoff(false) << "ms" << std::endl;
+  std::cout << "shm:          " << shm_handoff() << "ms" << std::endl;
+  return 0;
+}
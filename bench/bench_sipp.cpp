@@ -0,0 +1,94 @@
+/*
+ * single-agent queries against fixed paths: SIPP vs space-time A*
+ * fixed paths are from the planner, queries are further random agents
+ * usage: bench_sipp [width of empty grid] [#fixed paths] [#queries]
+ */
+#include <filesystem>
+#include <lacam2.hpp>
+
+int main(int argc, char* argv[])
+{
+  const int width = argc > 1 ? std::stoi(argv[1]) : 256;
+  const uint N_fixed = argc > 2 ? std::stoi(argv[2]) : 10000;
+  const uint num_queries = argc > 3 ? std::stoi(argv[3]) : 1000;
+  const uint num_queries_astar = std::min(num_queries, 20u);
+
+  // empty grid
+  const auto map_filename =
+      (std::filesystem::temp_directory_path() / "lacam2_bench_sipp.map")
+          .string();
+  {
+    std::ofstream file(map_filename);
+    file << "type octile\nheight " << width << "\nwidth " << width << "\nmap\n";
+    for (auto y = 0; y < width; ++y) file << std::string(width, '.') << "\n";
+  }
+  auto MT = std::mt19937(0);
+  const auto ins = Instance(map_filename, &MT, N_fixed + num_queries);
+  std::filesystem::remove(map_filename);
+
+  // fixed paths
+  const auto ins_fixed = Instance(ins, N_fixed);
+  auto additional_info = std::string();
+  const auto deadline = Deadline(60000);
+  const auto solution = solve(ins_fixed, additional_info, 0, &deadline, &MT);
+  if (solution.empty()) {
+    std::cout << "failed to solve fixed paths" << std::endl;
+    return 1;
+  }
+  const auto t_build = Deadline();
+  auto RT = ReservationTable(ins.G.size());
+  for (uint i = 0; i < N_fixed; ++i) {
+    auto path = Config();
+    for (auto& C : solution) path.push_back(C[i]);
+    RT.add(path);
+  }
+  auto sipp = SIPP(ins.G, RT);
+  std::cout << "fixed paths: " << N_fixed << ", makespan "
+            << get_makespan(solution) << ", build: " << t_build.elapsed_ms()
+            << "ms, intervals: " << sipp.intervals.size() << " ("
+            << (sipp.memory_usage() >> 10) << "KB)" << std::endl;
+
+  // heuristics first, shared by both
+  auto D = DistTable(ins);
+  const auto t_h = Deadline();
+  for (uint i = N_fixed; i < ins.N; ++i) D.get(i, ins.starts[i]);
+  std::cout << "heuristics: " << t_h.elapsed_ms() << "ms" << std::endl;
+
+  uint64_t cost_sipp = 0, cost_sipp_sub = 0, cost_astar = 0;
+  uint solved_sipp = 0, solved_astar = 0;
+  const auto t_sipp = Deadline();
+  for (uint i = N_fixed; i < ins.N; ++i) {
+    const auto path = sipp.find_path(ins.starts[i], D, i);
+    solved_sipp += !path.empty();
+    cost_sipp += path.size();
+    if (i < N_fixed + num_queries_astar) cost_sipp_sub += path.size();
+  }
+  const auto time_sipp = t_sipp.elapsed_ms();
+  // again, with heuristic rows complete
+  const auto t_warm = Deadline();
+  for (uint i = N_fixed; i < ins.N; ++i) sipp.find_path(ins.starts[i], D, i);
+  const auto time_warm = t_warm.elapsed_ms();
+  // space-time A* is much slower, on a subset
+  const auto t_astar = Deadline();
+  for (uint i = N_fixed; i < N_fixed + num_queries_astar; ++i) {
+    const auto path =
+        get_space_time_path(ins.G, RT, ins.starts[i], ins.goals[i]);
+    solved_astar += !path.empty();
+    cost_astar += path.size();
+  }
+  const auto time_astar = t_astar.elapsed_ms();
+
+  std::cout << "sipp:    " << num_queries / std::max(time_sipp, 1e-3) * 1000
+            << " queries/s, solved " << solved_sipp << "/" << num_queries
+            << ", cost " << cost_sipp
+            << ", expanded " << sipp.num_expanded << std::endl;
+  std::cout << "sipp, warm rows: "
+            << num_queries / std::max(time_warm, 1e-3) * 1000 << " queries/s"
+            << std::endl;
+  std::cout << "A*:      "
+            << num_queries_astar / std::max(time_astar, 1e-3) * 1000
+            << " queries/s, solved " << solved_astar << "/"
+            << num_queries_astar << ", cost " << cost_astar
+            << " (sipp: " << cost_sipp_sub << ")" << std::endl;
+  return 0;
+}
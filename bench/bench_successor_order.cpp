@@ -0,0 +1,48 @@
+/*
+ * compare low-level successor orderings
+ * usage: bench_successor_order [map] [N] [#seeds] [time_limit_sec] [scen]
+ */
+#include <lacam2.hpp>
+
+int main(int argc, char* argv[])
+{
+  const std::string map_name =
+      argc > 1 ? argv[1] : "./assets/random-32-32-20.map";
+  const uint N = argc > 2 ? std::stoi(argv[2]) : 400;
+  const int num_seeds = argc > 3 ? std::stoi(argv[3]) : 10;
+  const int time_limit_sec = argc > 4 ? std::stoi(argv[4]) : 10;
+  const std::string scen_name = argc > 5 ? argv[5] : "";
+
+  std::cout << "order\tseed\tsolved\tloop_cnt\tnode_cnt\tcomp_time_ms\tsoc"
+            << std::endl;
+  for (auto order : {ORDER_RANDOM, ORDER_DIST}) {
+    auto options = PlannerOptions();
+    options.successor_order = order;
+    int solved = 0;
+    double sum_loop_cnt = 0, sum_time = 0;
+    for (int seed = 0; seed < num_seeds; ++seed) {
+      auto MT = std::mt19937(seed);
+      const auto ins = scen_name.empty() ? Instance(map_name, &MT, N)
+                                         : Instance(scen_name, map_name, N);
+      if (!ins.is_valid(1)) return 1;
+      const auto deadline = Deadline(time_limit_sec * 1000);
+      auto additional_info = std::string("");
+      HNode::HNODE_CNT = 0;
+      auto planner = Planner(&ins, &deadline, &MT, 0, OBJ_NONE, 0.001,
+                             nullptr, options);
+      const auto solution = planner.solve(additional_info);
+      const auto comp_time_ms = deadline.elapsed_ms();
+      solved += !solution.empty();
+      sum_loop_cnt += planner.loop_cnt;
+      sum_time += comp_time_ms;
+      std::cout << order << "\t" << seed << "\t" << !solution.empty() << "\t"
+                << planner.loop_cnt << "\t" << HNode::HNODE_CNT << "\t"
+                << comp_time_ms << "\t" << get_sum_of_costs(solution)
+                << std::endl;
+    }
+    std::cout << "# " << order << ": solved " << solved << "/" << num_seeds
+              << ", loop_cnt(avg)=" << sum_loop_cnt / num_seeds
+              << ", comp_time_ms(avg)=" << sum_time / num_seeds << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,68 @@
+#include <argparse/argparse.hpp>
+#include <lacam2.hpp>
+
+int main(int argc, char* argv[])
+{
+  // arguments parser
+  argparse::ArgumentParser program("experiment", "0.1.0");
+  program.add_argument("-d", "--dir")
+      .help("directory of MovingAI maps and scenarios, searched recursively")
+      .required();
+  program.add_argument("--step")
+      .help("N = step, 2 * step, ... until the first failure")
+      .default_value(std::string("50"));
+  program.add_argument("--max_N")
+      .help("max number of agents, 0: all agents of each scenario")
+      .default_value(std::string("0"));
+  program.add_argument("-s", "--seed")
+      .help("seed")
+      .default_value(std::string("0"));
+  program.add_argument("-v", "--verbose")
+      .help("verbose")
+      .default_value(std::string("1"));
+  program.add_argument("-t", "--time_limit_sec")
+      .help("time limit sec")
+      .default_value(std::string("30"));
+  program.add_argument("-j", "--threads")
+      .help("scenarios solved in parallel, 0: hardware concurrency")
+      .default_value(std::string("0"));
+  program.add_argument("--runs")
+      .help("output file, one line per run; CSV, or JSONL if *.jsonl")
+      .default_value(std::string("./build/experiment_runs.csv"));
+  program.add_argument("-o", "--output")
+      .help("output file, one line per map and N")
+      .default_value(std::string("./build/experiment_summary.csv"));
+
+  try {
+    program.parse_known_args(argc, argv);
+  } catch (const std::runtime_error& err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    std::exit(1);
+  }
+
+  const auto verbose = std::stoi(program.get<std::string>("verbose"));
+  auto num_threads = std::stoi(program.get<std::string>("threads"));
+  if (num_threads <= 0) {
+    num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+  auto exp = Experiment(std::stoi(program.get<std::string>("step")),
+                        std::stoi(program.get<std::string>("max_N")),
+                        std::stoi(program.get<std::string>("time_limit_sec")) *
+                            1000.0,
+                        std::stoi(program.get<std::string>("seed")), verbose);
+  const auto dir = program.get<std::string>("dir");
+  if (exp.find_tasks(dir) == 0) {
+    info(0, verbose, "no pair of map and scenario in ", dir);
+    return 1;
+  }
+  info(1, verbose, "scenarios: ", exp.tasks.size(), ", threads: ", num_threads);
+
+  const auto deadline = Deadline();
+  exp.run(num_threads);
+  exp.write_runs(program.get<std::string>("runs"));
+  exp.write_summary(program.get<std::string>("output"));
+  info(1, verbose, "done: ", exp.runs.size(), " runs in ",
+       deadline.elapsed_ms(), "ms");
+  return 0;
+}
@@ -0,0 +1,67 @@
+/*
+ * disk-backed store of cold configurations, for explored sets beyond RAM
+ * configurations are spilled to sorted runs with varint-compressed vertex ids;
+ * a run file holds records sorted by fingerprint, then (id, fingerprint)
+ * pairs sorted by id; in memory, each run keeps a Bloom filter and sparse
+ * indexes of both sections, i.e., about two bytes per record
+ * runs are merged like a binary counter, hence O(log) runs
+ */
+#pragma once
+#include "graph.hpp"
+#include "utils.hpp"
+
+struct ColdStore {
+  static constexpr size_t BLOCK_SIZE = 64;   // records per index entry
+  static constexpr size_t BLOOM_BITS = 10;   // bits per record
+  static constexpr size_t BLOOM_HASHES = 7;  // #(hash functions)
+
+  // records sorted by (fingerprint, id); record: fingerprint, id, vertex ids
+  // then the id section, sorted by id; entry: id, fingerprint
+  struct Run {
+    std::string filename;
+    int fd;
+    size_t num_records;
+    size_t num_bits;                     // of the Bloom filter
+    std::vector<uint64_t> bloom;         // bit array
+    std::vector<uint64_t> index_fp;      // first fingerprint of each block
+    std::vector<uint64_t> index_offset;  // offset of each block, + id_begin
+    std::vector<uint64_t> index_id;      // first id of each block of ids
+    uint64_t id_last;                    // largest id
+    uint64_t id_begin;                   // offset of the id section
+    uint64_t size;                       // of the file
+  };
+
+  const std::string dir;
+  const Vertices& V;  // to decode vertex ids
+  const uint N;       // size of configurations
+  std::vector<Run*> runs;  // older first
+  size_t next_run;         // for file names
+
+  // statistics
+  size_t num_spilled;
+  size_t num_merges;
+  size_t num_block_reads;
+  size_t num_bloom_rejects;
+
+  ColdStore(const std::string& _dir, const Vertices& _V, const uint _N);
+  ~ColdStore();
+
+  static uint64_t get_fingerprint(const Config& C);
+
+  // ids are opaque to the store, e.g., addresses of high-level nodes
+  // false when the run file cannot be written; nothing is stored then
+  bool spill(const std::vector<std::pair<uint64_t, const Config*> >& entries);
+  bool find(const Config& C, uint64_t& id);  // id of the same configuration
+  // configuration of id, false when unknown or unreadable
+  bool read(const uint64_t id, Config& C);
+  size_t disk_usage() const;
+
+  // internal
+  Run* create_run();  // fd < 0 on failure
+  void remove_run(Run* run);
+  Run* merge(const Run* older, const Run* newer);  // nullptr on failure
+  void merge_runs();  // while the second newest run is not larger
+  // record of fp in run, matched by C or otherwise by id; decoded into out
+  bool search(const Run* run, const uint64_t fp, const Config* C,
+              uint64_t& id, Config* out);
+};
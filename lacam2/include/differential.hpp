@@ -0,0 +1,55 @@
+/*
+ * differential testing of optimized code paths against plain references
+ * - distances: lazy, full, bounded and landmark DistTable vs BFS from scratch
+ * - configuration generation: incremental PIBT vs PIBT from scratch
+ * - planner: feasibility and determinism under optimization switches
+ * divergences are reported with an instance reduced to the fewest agents
+ */
+#pragma once
+#include "dist_table.hpp"
+#include "instance.hpp"
+#include "planner.hpp"
+#include "utils.hpp"
+
+// distances to goal over reverse edges, by vertex id; V_size: unreachable
+std::vector<uint> get_reference_distances(const Graph& G, Vertex* goal);
+
+// PIBT from scratch at every call, without caches and incremental updates
+struct ReferencePIBT {
+  const Instance* ins;
+  std::mt19937* MT;
+  const uint N;
+  std::vector<std::vector<uint> > dist;  // per agent, by vertex id
+  std::vector<float> tie_breakers;       // kept across calls, as in PIBT
+  std::vector<int> occupied_now;         // agent id, -1 -> empty
+  std::vector<int> occupied_next;
+  Config C_now;
+  Config C_next;  // result
+
+  ReferencePIBT(const Instance* _ins, std::mt19937* _MT);
+  // constraints: (agent, vertex) from the low-level root
+  bool get_new_config(
+      const Config& C, const std::vector<uint>& order,
+      const std::vector<std::pair<uint, Vertex*> >& constraints);
+  bool funcPIBT(const uint i);
+};
+
+// additional check, e.g., of a new code path; divergence or empty
+using DifferentialCheck =
+    std::function<std::string(const Instance& ins, const int seed)>;
+
+// first divergence on ins, empty -> none
+std::string check_differential(const Instance& ins, const int seed,
+                               const uint num_pibt_calls = 200,
+                               const DifferentialCheck& extra = nullptr);
+
+// reproducer of a divergence, dropping agents while it persists
+std::string minimize_divergence(const std::string& map_filename,
+                                const Instance& ins, const int seed,
+                                const uint num_pibt_calls = 200,
+                                const DifferentialCheck& extra = nullptr);
+
+// random instances with 1..max_N agents; number of divergent instances
+uint run_differential(const std::string& map_filename,
+                      const uint num_instances, const uint max_N,
+                      const int seed = 0, const int verbose = 0);
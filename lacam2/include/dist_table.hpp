@@ -1,23 +1,59 @@
 /*
  * distance table with lazy evaluation, using BFS
+ * or landmark lower bounds when full rows are unaffordable
+ * or bounded BFS with Manhattan lower bounds for fast startup on huge maps
  */
 #pragma once
 
 #include "graph.hpp"
+#include "huge_pages.hpp"
 #include "instance.hpp"
+#include "landmarks.hpp"
 #include "utils.hpp"
 
+enum DistMode { DIST_BFS, DIST_LANDMARK, DIST_BOUNDED };
+
+// settings, fixed at construction
+struct DistOptions {
+  DistMode mode = DIST_BFS;
+  uint num_landmarks = 16;
+  LandmarkSelection landmark_selection = LANDMARK_FARTHEST;
+  uint landmark_radius = 8;  // exact distances around goals
+  uint bfs_radius = 0;       // DIST_BOUNDED, free expansions around goals
+  uint bfs_budget = 64;      // DIST_BOUNDED, expansions per query beyond
+  bool numa = false;         // setup_all: rows split into blocks by node
+  bool huge_pages = false;   // table
+};
+
 struct DistTable {
+  const DistOptions options;
+  const DistMode mode;
   const uint V_size;  // number of vertices
-  std::vector<std::vector<uint> >
-      table;          // distance table, index: agent-id & vertex-id
+  const uint width;   // grid width, for Manhattan distances
+  const Vertices* V;
+  // distance table, flat; index: agent-id * V_size + vertex-id
+  HugeVector<uint> table;
   std::vector<std::queue<Vertex*> > OPEN;  // search queue
+  std::vector<Vertex*> goals;              // BFS roots
+  Landmarks landmarks;                     // DIST_LANDMARK only
+  size_t num_lower_bounds;  // DIST_BOUNDED, queries answered by bounds
 
   inline uint get(uint i, uint v_id);      // agent, vertex-id
   uint get(uint i, Vertex* v);             // agent, vertex
+  // exact if known, otherwise max of Manhattan and the BFS frontier depth
+  uint get_lower_bound(uint i, uint v_id, uint d_frontier) const;
 
-  DistTable(const Instance& ins);
-  DistTable(const Instance* ins);
+  DistTable(const Instance& ins, const DistOptions& _options = DistOptions());
+  DistTable(const Instance* ins, const DistOptions& _options = DistOptions());
 
-  void setup(const Instance* ins);  // initialization
+  void setup(const Instance* ins);  // initialization, of rows not yet set
+  // rows for ins->goals on the same graph, keeping those with the same goals
+  void extend(const Instance* ins);
+  // complete BFS for all agents, after which get() is read-only (thread-safe)
+  // with options.numa, rows are split into blocks by node and filled there
+  void setup_all(ThreadPool* pool = nullptr);
+  uint get_row_node(const uint i) const;  // node of agent i's row
+  size_t memory_usage() const;             // bytes
 };
+
+std::ostream& operator<<(std::ostream& os, const DistMode mode);
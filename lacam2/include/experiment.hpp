@@ -0,0 +1,50 @@
+/*
+ * experiment runner over MovingAI benchmarks
+ * c.f., https://movingai.com/benchmarks/mapf.html
+ *
+ * every .scen under a directory is paired with its .map by the map name in
+ * the file; each scenario is solved with N = step, 2 * step, ... until the
+ * first failure, scenarios in parallel on a ThreadPool
+ * one distance table per scenario is extended over N and used for both
+ * solving and lower bounds, exact with DIST_BFS only
+ */
+#pragma once
+#include "instance.hpp"
+#include "planner.hpp"
+#include "utils.hpp"
+
+struct ExperimentRun {
+  std::string map_name;   // file name, e.g., random-32-32-10.map
+  std::string scen_name;
+  uint N;
+  bool solved;
+  double comp_time_ms;
+  int makespan;
+  int makespan_lb;
+  int sum_of_costs;
+  int sum_of_costs_lb;
+};
+
+struct Experiment {
+  const uint step;       // increment of N
+  const uint max_N;      // 0 -> all agents of the scenario
+  const double time_limit_ms;
+  const int seed;
+  const int verbose;
+  PlannerOptions options;  // of every run
+
+  std::vector<std::pair<std::string, std::string> > tasks;  // (map, scen)
+  std::vector<ExperimentRun> runs;  // by task, then N
+
+  Experiment(const uint _step, const uint _max_N, const double _time_limit_ms,
+             const int _seed = 0, const int _verbose = 0);
+
+  // pairs of map and scenario files under dir, sorted; number of pairs
+  size_t find_tasks(const std::string& dir);
+  void run(const uint num_threads);
+  // one line per run, CSV or JSONL by the extension
+  void write_runs(const std::string& filename) const;
+  // per map and N: success rate over scenarios, mean runtime and mean cost
+  // ratios against lower bounds over solved ones
+  void write_summary(const std::string& filename) const;
+};
@@ -0,0 +1,134 @@
+/*
+ * explored set of configurations, open addressing with linear probing
+ * batched lookups compute hashes together and prefetch buckets and nodes
+ * before comparing configurations
+ */
+#pragma once
+#include "graph.hpp"
+#include "huge_pages.hpp"
+#include "utils.hpp"
+
+// Node: any type with a member C (configuration) used as the key
+template <typename Node>
+struct Explored {
+  struct Slot {
+    uint hash;
+    Node* node;  // nullptr -> empty
+  };
+  HugeVector<Slot> slots;    // size: power of two
+  std::vector<Node*> nodes;  // insertion order, including erased ones
+  size_t num_entries;        // #(nodes) in slots
+  uint shift;                // for fibonacci hashing
+
+  Explored(const size_t capacity = 1024, const bool huge_pages = false)
+      : slots(HugeAllocator<Slot>(huge_pages)),
+        nodes(),
+        num_entries(0),
+        shift(0)
+  {
+    rehash(capacity);
+  }
+
+  size_t size() const { return nodes.size(); }
+
+  static uint get_hash(const Config& C) { return ConfigHasher()(C); }
+
+  size_t get_index(const uint hash) const
+  {
+    return ((uint64_t)hash * 0x9e3779b97f4a7c15ULL) >> shift;
+  }
+
+  Node* find(const Config& C) const { return find(C, get_hash(C)); }
+
+  Node* find(const Config& C, const uint hash) const
+  {
+    const size_t mask = slots.size() - 1;
+    for (auto k = get_index(hash);; k = (k + 1) & mask) {
+      const auto& slot = slots[k];
+      if (slot.node == nullptr) return nullptr;
+      if (slot.hash == hash && is_same_config(slot.node->C, C))
+        return slot.node;
+    }
+  }
+
+  // Cs[k] -> hashes[k], res[k] (nullptr when not found)
+  void find_batch(const std::vector<const Config*>& Cs,
+                  std::vector<uint>& hashes, std::vector<Node*>& res) const
+  {
+    const auto n = Cs.size();
+    hashes.resize(n);
+    res.resize(n);
+    // stage 1: hashes, prefetch buckets
+    for (size_t k = 0; k < n; ++k) {
+      hashes[k] = get_hash(*Cs[k]);
+      __builtin_prefetch(&slots[get_index(hashes[k])]);
+    }
+    // stage 2: prefetch candidate nodes in the buckets
+    for (size_t k = 0; k < n; ++k) {
+      const auto& slot = slots[get_index(hashes[k])];
+      if (slot.node != nullptr && slot.hash == hashes[k])
+        __builtin_prefetch(slot.node);
+    }
+    // stage 3: compare configurations
+    for (size_t k = 0; k < n; ++k) res[k] = find(*Cs[k], hashes[k]);
+  }
+
+  void insert(Node* node) { insert(node, get_hash(node->C)); }
+
+  void insert(Node* node, const uint hash)
+  {
+    nodes.push_back(node);
+    place(node, hash);
+  }
+
+  // remove from the table, keeping it in nodes; backward-shift deletion
+  void erase(Node* node, const uint hash)
+  {
+    const size_t mask = slots.size() - 1;
+    auto k = get_index(hash);
+    while (slots[k].node != node) {
+      if (slots[k].node == nullptr) return;
+      k = (k + 1) & mask;
+    }
+    for (auto j = (k + 1) & mask; slots[j].node != nullptr; j = (j + 1) & mask) {
+      // move back when the home position is not within (k, j]
+      const auto home = get_index(slots[j].hash);
+      if (((j - home) & mask) >= ((j - k) & mask)) {
+        slots[k] = slots[j];
+        k = j;
+      }
+    }
+    slots[k] = Slot{0, nullptr};
+    --num_entries;
+  }
+
+  // re-insert a node erased before
+  void restore(Node* node, const uint hash) { place(node, hash); }
+
+  void rehash(const size_t capacity)
+  {
+    size_t size = 2;
+    shift = 63;
+    while (size < capacity) {
+      size *= 2;
+      --shift;
+    }
+    auto old_slots =
+        HugeVector<Slot>(size, Slot{0, nullptr}, slots.get_allocator());
+    std::swap(slots, old_slots);
+    num_entries = 0;
+    for (auto& slot : old_slots) {
+      if (slot.node != nullptr) place(slot.node, slot.hash);
+    }
+  }
+
+  void place(Node* node, const uint hash)
+  {
+    if ((num_entries + 1) * 2 > slots.size()) rehash(slots.size() * 2);
+    ++num_entries;
+    const size_t mask = slots.size() - 1;
+    auto k = get_index(hash);
+    while (slots[k].node != nullptr) k = (k + 1) & mask;
+    slots[k] = Slot{hash, node};
+  }
+};
@@ -7,18 +7,23 @@
 struct Vertex {
   const uint id;     // index for V in Graph
   const uint index;  // index for U, width * y + x, in Graph
-  std::vector<Vertex*> neighbor;
+  std::vector<Vertex*> neighbor;     // reachable in one step
+  std::vector<Vertex*> in_neighbor;  // reaching here in one step, for BFS
 
   Vertex(uint _id, uint _index);
 };
 using Vertices = std::vector<Vertex*>;
 using Config = std::vector<Vertex*>;  // a set of locations for all agents
 
+// map cells: '.' free, 'T' / '@' obstacle,
+// '>' '<' '^' 'v' one-way, leaving only east / west / north / south
+// ('^' is toward the previous line); any cell can be entered from neighbors
 struct Graph {
   Vertices V;                          // without nullptr
   Vertices U;                          // with nullptr
   uint width;                          // grid width
   uint height;                         // grid height
+  bool directed;                       // with one-way cells
   Graph();
   Graph(const std::string& filename);  // taking map filename
   ~Graph();
@@ -0,0 +1,32 @@
+/*
+ * per-vertex congestion metrics, for layout analysis
+ * indexed by Graph::U (width * y + x); search metrics come from PIBT,
+ * visits and waits from the solution
+ */
+#pragma once
+#include "instance.hpp"
+#include "utils.hpp"
+
+struct Heatmap {
+  enum Metric { VISITS, WAITS, CONFLICTS, PUSHES, NUM_METRICS };
+  static const char* METRIC_NAMES[NUM_METRICS];
+
+  const Graph& G;
+  // index: Graph::U
+  std::array<std::vector<uint64_t>, NUM_METRICS> values;
+
+  Heatmap(const Graph& _G);
+
+  // counts indexed by vertex id, e.g., from PIBT
+  void add_by_id(const Metric metric, const std::vector<uint64_t>& counts);
+  // visits: arrivals incl. starts, waits: stays before reaching goals finally
+  void add_solution(const Instance& ins, const Solution& solution);
+
+  // *.bin -> binary, otherwise CSV
+  bool write(const std::string& filename) const;
+  // rows: index,x,y,visits,waits,conflicts,pushes; vertices only
+  bool write_csv(const std::string& filename) const;
+  // "LCHM", u32 width, u32 height, u32 #(metrics), then u64 arrays per
+  // metric over all cells, UINT64_MAX for obstacles
+  bool write_binary(const std::string& filename) const;
+};
@@ -0,0 +1,59 @@
+/*
+ * allocator backed by 2MB huge pages, for large solver arrays
+ * tries explicit huge pages (MAP_HUGETLB) first, then transparent huge pages
+ * via madvise; small arrays and disabled allocators use the default heap
+ * regions record how they were allocated, so any allocator frees any region
+ */
+#pragma once
+#include "utils.hpp"
+
+struct HugePages {
+  static constexpr size_t PAGE_SIZE = 2 * 1024 * 1024;
+
+  // statistics, #(bytes) currently mapped by each method
+  static std::atomic<size_t> bytes_hugetlb;
+  static std::atomic<size_t> bytes_thp;
+
+  static void* allocate(const size_t bytes, const bool huge);
+  static void deallocate(void* p, const size_t bytes);
+};
+
+template <typename T>
+struct HugeAllocator {
+  using value_type = T;
+  // the setting follows the contents
+  using propagate_on_container_copy_assignment = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  bool huge;  // false -> default heap
+
+  HugeAllocator(const bool _huge = false) : huge(_huge) {}
+  template <typename U>
+  HugeAllocator(const HugeAllocator<U>& other) : huge(other.huge)
+  {
+  }
+
+  T* allocate(const size_t n)
+  {
+    return static_cast<T*>(HugePages::allocate(n * sizeof(T), huge));
+  }
+  void deallocate(T* p, const size_t n)
+  {
+    HugePages::deallocate(p, n * sizeof(T));
+  }
+};
+
+template <typename T, typename U>
+bool operator==(const HugeAllocator<T>&, const HugeAllocator<U>&)
+{
+  return true;
+}
+template <typename T, typename U>
+bool operator!=(const HugeAllocator<T>&, const HugeAllocator<U>&)
+{
+  return false;
+}
+
+template <typename T>
+using HugeVector = std::vector<T, HugeAllocator<T> >;
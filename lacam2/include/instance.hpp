@@ -3,13 +3,15 @@
  * 配置 starts and goals
  */
 #pragma once
+#include <memory>
 #include <random>
 
 #include "graph.hpp"
 #include "utils.hpp"
 
 struct Instance {
-  const Graph G;
+  const std::shared_ptr<Graph> graph;  // shared with prefix instances
+  const Graph& G;
   Config starts;
   Config goals;
   const uint N;  // number of agents
@@ -24,6 +26,8 @@ struct Instance {
   // random instance generation
   Instance(const std::string& map_filename, std::mt19937* MT,
            const uint _N = 1);
+  // first _N agents of base, sharing the graph; e.g., sweep over N
+  Instance(const Instance& base, const uint _N);
   ~Instance() {}
 
   // simple feasibility check of instance
@@ -0,0 +1,48 @@
+/*
+ * minimal JSON serializer, appending to a string without intermediate trees
+ * numbers are formatted by std::to_chars
+ */
+#pragma once
+#include <string>
+#include <type_traits>
+#include <vector>
+
+struct JsonWriter {
+  std::string buf;
+  std::vector<bool> is_first;  // per open object/array, no element yet
+  bool after_key;
+
+  JsonWriter();
+  JsonWriter& begin_object();
+  JsonWriter& end_object();
+  JsonWriter& begin_array();
+  JsonWriter& end_array();
+  JsonWriter& key(const std::string& k);
+  JsonWriter& value(const std::string& v);
+  JsonWriter& value(const char* v) { return value(std::string(v)); }
+  template <typename T>
+  std::enable_if_t<std::is_arithmetic_v<T>, JsonWriter&> value(const T v)
+  {
+    if constexpr (std::is_same_v<T, bool>) {
+      separate();
+      buf += v ? "true" : "false";
+    } else if constexpr (std::is_integral_v<T>) {
+      if constexpr (std::is_signed_v<T>) {
+        append_int((long long)v);
+      } else {
+        append_uint((unsigned long long)v);
+      }
+    } else {
+      append_double((double)v);
+    }
+    return *this;
+  }
+  // text of key=value logs: a number, comma-separated numbers as an array,
+  // otherwise a string
+  JsonWriter& value_of_text(const std::string& text);
+
+  void separate();  // comma between elements
+  void append_int(const long long v);
+  void append_uint(const unsigned long long v);
+  void append_double(const double v);  // null if not finite
+};
@@ -1,14 +1,33 @@
 #pragma once
 
+#include "cold_store.hpp"
+#include "differential.hpp"
 #include "dist_table.hpp"
+#include "experiment.hpp"
+#include "explored.hpp"
 #include "graph.hpp"
+#include "heatmap.hpp"
+#include "huge_pages.hpp"
 #include "instance.hpp"
+#include "json.hpp"
+#include "landmarks.hpp"
+#include "logger.hpp"
+#include "numa_placement.hpp"
+#include "perf_counters.hpp"
 #include "planner.hpp"
+#include "portfolio.hpp"
 #include "post_processing.hpp"
+#include "replan.hpp"
+#include "shm_handoff.hpp"
+#include "sipp.hpp"
+#include "solution_cache.hpp"
 #include "utils.hpp"
 
 // main function
 Solution solve(const Instance& ins, std::string& additional_info,
                const int verbose = 0, const Deadline* deadline = nullptr,
                std::mt19937* MT = nullptr, const Objective objective = OBJ_NONE,
-               const float restart_rate = 0.001);
+               const float restart_rate = 0.001,
+               SolutionCache* cache = nullptr, Heatmap* heatmap = nullptr,
+               DistTable* D = nullptr,
+               const PlannerOptions& options = PlannerOptions());
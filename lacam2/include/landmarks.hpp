@@ -0,0 +1,33 @@
+/*
+ * landmark (ALT) lower bounds of distances, for memory-constrained tables
+ * d(v, g) >= max_l { d(l, g) - d(l, v), d(v, l) - d(g, l) };
+ * exact distances within a radius of each goal are kept by bounded BFS
+ */
+#pragma once
+#include "graph.hpp"
+#include "instance.hpp"
+#include "utils.hpp"
+
+enum LandmarkSelection { LANDMARK_RANDOM, LANDMARK_FARTHEST };
+
+struct Landmarks {
+  uint V_size;
+  uint K;       // number of landmarks
+  uint radius;  // exact within this distance to goals
+  Vertices vertices;
+  // index: vertex-id * K + landmark, V_size -> unreachable
+  std::vector<uint> dist_from;  // d(landmark, v)
+  std::vector<uint> dist_to;    // d(v, landmark), empty on undirected maps
+  std::vector<uint> goal_from;  // index: agent * K + landmark, d(landmark, g)
+  std::vector<uint> goal_to;    // d(g, landmark)
+  // per agent, sorted by vertex id: exact d(v, goal) within radius
+  std::vector<std::vector<std::pair<uint, uint> > > balls;
+
+  Landmarks();
+  void setup(const Instance* ins, const uint _K,
+             const LandmarkSelection selection, const uint _radius);
+  uint get(const uint i, const uint v_id) const;  // agent, vertex-id
+  size_t memory_usage() const;  // bytes
+};
+
+std::ostream& operator<<(std::ostream& os, const LandmarkSelection selection);
@@ -0,0 +1,35 @@
+/*
+ * logging backend of info() and solver_info()
+ *
+ * callers format a line into a thread-local buffer; by default it is
+ * written to the sinks at once, after start() it is pushed to a bounded
+ * lock-free queue and written in batches by a background thread
+ * buffers are swapped with queue slots, so no allocation in steady state
+ */
+#pragma once
+
+#include <functional>
+#include <ostream>
+#include <string>
+
+struct Logger {
+  using Sink = std::function<void(const std::string& lines)>;
+  static constexpr size_t CAPACITY = 1 << 12;  // queued lines, power of two
+
+  // a line: begin() returns the stream, end() adds the newline and emits it
+  static std::ostream& begin();
+  static void end();
+
+  // background writer; stop() drains the queue, also called at exit
+  // after fork(), the child logs synchronously
+  static void start();
+  static void stop();
+  static bool is_async();
+  static void flush();  // waits until lines logged so far are written
+
+  // sinks receive batches of complete lines; std::cout by default
+  static void add_sink(const Sink& sink);
+  static bool add_file_sink(const std::string& filename);
+  static void add_stdout_sink();
+  static void clear_sinks();
+};
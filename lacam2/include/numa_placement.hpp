@@ -0,0 +1,23 @@
+/*
+ * NUMA-aware placement of threads and memory
+ * uses libnuma when built with LACAM_HAS_NUMA; otherwise reads the topology
+ * from sysfs and relies on first-touch after dropping pages
+ */
+#pragma once
+#include "utils.hpp"
+
+struct Numa {
+  static int num_nodes();  // 1 when unknown
+  static int node_of_worker(const size_t worker_id);  // round-robin
+  static bool pin_thread(const int node);  // the calling thread
+  // worker k -> node_of_worker(k); the caller runs worker 0, so its
+  // affinity is saved and must be restored by unpin_caller()
+  static void pin_pool(ThreadPool* pool);
+  static void unpin_caller();
+
+  // move [p, p + bytes) to node, only whole pages inside the range;
+  // contents may be discarded, the caller must initialize the range again
+  // from a thread running on node
+  static void place(void* p, const size_t bytes, const int node);
+  static int node_of_address(const void* p);  // -1 when unknown
+};
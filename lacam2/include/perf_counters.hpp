@@ -0,0 +1,39 @@
+/*
+ * hardware performance counters per solver phase, via perf_event_open
+ * counts only the calling thread; when counters are unavailable (e.g.,
+ * perf_event_paranoid, containers), all calls are no-ops
+ * when the kernel multiplexes counters, values are scaled by
+ * enabled / running time, i.e., estimates
+ */
+#pragma once
+#include "utils.hpp"
+
+struct PerfCounters {
+  enum Event { CYCLES, INSTRUCTIONS, LLC_MISSES, BRANCH_MISSES, NUM_EVENTS };
+  using Values = std::array<uint64_t, NUM_EVENTS>;
+
+  int group_fd;  // leader: cycles
+  std::array<int, NUM_EVENTS> fds;
+  bool available;
+  const std::vector<std::string> phase_names;
+  std::vector<Values> totals;      // per phase
+  std::vector<uint64_t> num_calls;  // per phase
+  Values last;                     // at start()
+  uint64_t last_enabled;           // ns, at start()
+  uint64_t last_running;           // ns, at start()
+  uint64_t time_enabled;           // ns, in all phases
+  uint64_t time_running;           // ns, counting; < enabled if multiplexed
+
+  // no-op unless enabled
+  PerfCounters(const std::vector<std::string>& _phase_names,
+               const bool enabled = false);
+  ~PerfCounters();
+  // owns the fds, closed by the destructor
+  PerfCounters(const PerfCounters&) = delete;
+  PerfCounters& operator=(const PerfCounters&) = delete;
+
+  bool read(Values& values, uint64_t& enabled, uint64_t& running) const;
+  void start();
+  void stop(const uint phase);  // add the difference from start() to phase
+  std::string get_stats() const;  // key=value lines
+};
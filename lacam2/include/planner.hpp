@@ -4,15 +4,53 @@
 
 #pragma once
 
+#include "cold_store.hpp"
 #include "dist_table.hpp"
+#include "explored.hpp"
 #include "graph.hpp"
+#include "heatmap.hpp"
 #include "instance.hpp"
+#include "numa_placement.hpp"
+#include "perf_counters.hpp"
 #include "utils.hpp"
 
 // objective function
 enum Objective { OBJ_NONE, OBJ_MAKESPAN, OBJ_SUM_OF_LOSS };
 std::ostream& operator<<(std::ostream& os, const Objective objective);
 
+// order of constraints (successors) in the low-level search
+enum SuccessorOrder { ORDER_RANDOM, ORDER_DIST };
+std::ostream& operator<<(std::ostream& os, const SuccessorOrder order);
+
+// planner phases measured by hardware counters
+enum PerfPhase {
+  PHASE_SETUP,     // distance table
+  PHASE_LOWLEVEL,  // constraint tree
+  PHASE_PIBT,      // configuration generation, incl. lazy distance queries
+  PHASE_EXPLORED,  // lookups of the explored set
+  PHASE_REGISTER,  // node creation and Dijkstra updates
+};
+
+// tuning knobs, fixed per planner
+struct PlannerOptions {
+  SuccessorOrder successor_order = ORDER_RANDOM;  // low-level successors
+  // with an objective, keep refining after the first solution until the
+  // deadline or optimality; false -> stop at the first solution
+  bool refine = false;
+  uint num_threads = 1;  // >1 -> batched parallel expansion, experimental
+  uint gc_interval = 10000;       // compaction during refinement, 0: off
+  std::string cold_dir = "";      // disk-backed explored set, empty: off
+  // max #(configurations) kept in memory; the cold store keeps about two
+  // bytes per spilled configuration in RAM, but spilled nodes remain as
+  // stubs (parent, neighbors, costs), i.e., RAM still grows with #(nodes)
+  size_t hot_capacity = 1000000;
+  bool numa = false;        // workers allocate on their own nodes
+  bool huge_pages = false;  // arrays of PIBT and the explored set
+  bool perf = false;        // hardware counters, see PerfPhase
+  bool pibt_stats = false;  // collect PIBTStats
+  DistOptions dist;         // of the own distance table, unless given
+};
+
 // PIBT agent
 struct Agent {
   const uint id;
@@ -34,84 +72,157 @@ struct LNode {
 
 // high-level node
 struct HNode {
-  static uint HNODE_CNT;  // count #(high-level node)
-  const Config C;
+  static std::atomic<uint> HNODE_CNT;  // count #(high-level node)
+  Config C;  // empty while spilled to the cold store
 
   // tree
   HNode* parent;
-  std::set<HNode*> neighbor;
+  std::map<HNode*, uint> neighbor;  // with edge costs
 
   // costs
   uint g;        // g-value (might be updated)
   const uint h;  // h-value
   uint f;        // g + h (might be updated)
 
-  // for low-level search
+  // for low-level search, freed by compact() when dominated
   std::vector<float> priorities;
   std::vector<uint> order;
   std::queue<LNode*> search_tree;
+  std::vector<LNode*> lnodes;  // all created low-level nodes, for deletion
+  // successors generated in advance (batched mode), reversed
+  // (node, already explored)
+  std::vector<std::pair<HNode*, bool> > pending;
 
   HNode(const Config& _C, DistTable& D, HNode* _parent, const uint _g,
         const uint _h);
   ~HNode();
+  void setup_lowlevel(DistTable& D);  // priorities, order, search tree
+  void compact();  // free low-level search, keeping C for duplicate detection
+  bool is_compacted() const;
 };
 using HNodes = std::vector<HNode*>;
 
+// diagnostics of configuration generation
+struct PIBTStats {
+  uint64_t num_calls;             // of get_new_config
+  uint64_t num_fail_constraints;  // inconsistent low-level constraints
+  uint64_t num_fail_pibt;         // PIBT could not move all agents
+  Histogram chain_depth;     // max inheritance depth, per top-level funcPIBT
+  Histogram num_candidates;  // candidates tried, per funcPIBT
+  Histogram depth_at_fail;   // low-level depth, when get_new_config fails
+
+  PIBTStats();
+  void merge(const PIBTStats& other);
+  std::string str() const;  // key=value lines
+};
+
+// configuration generator with its own occupancy, one per thread
+struct PIBT {
+  const Instance* ins;
+  DistTable& D;
+  std::mt19937* MT;
+  const uint N;       // number of agents
+  const uint V_size;  // number of vertices
+  const int FLG_SWAP = 0;
+
+  std::vector<std::array<Vertex*, 5> > C_next;  // next locations, used in PIBT
+  HugeVector<float> tie_breakers;               // random values, used in PIBT
+  Agents A;
+  HugeVector<Agent*> occupied_now;              // for quick collision checking
+  HugeVector<Agent*> occupied_next;             // for quick collision checking
+
+  // incremental constraint application in get_new_config
+  HNode* H_applied;                  // node of occupied_now
+  LNode* L_applied;                  // constraints in occupied_next
+  Agents pibt_placed;                // agents moved by PIBT in the last call
+  std::vector<LNode*> constraints;   // buffer, constraints to be applied
+
+  // diagnostics
+  const bool diagnostics;  // collect stats
+  PIBTStats stats;
+  uint chain_depth_now;  // of the recursion in funcPIBT
+  uint chain_depth_max;
+  // per vertex id, empty -> not collected
+  std::vector<uint64_t> vertex_conflicts;  // candidates rejected by conflicts
+  std::vector<uint64_t> vertex_pushes;     // priority inheritance from there
+
+  PIBT(const Instance* _ins, DistTable& _D, std::mt19937* _MT,
+       const PlannerOptions& options = PlannerOptions());
+  ~PIBT();
+  bool get_new_config(HNode* H, LNode* L);  // result: v_next of agents
+  bool funcPIBT(Agent* ai);
+  void reset();  // forget the applied node
+
+  // swap operation
+  Agent* swap_possible_and_required(Agent* ai);
+  bool is_swap_required(const uint pusher, const uint puller,
+                        Vertex* v_pusher_origin, Vertex* v_puller_origin);
+  bool is_swap_possible(Vertex* v_pusher_origin, Vertex* v_puller_origin);
+};
+
 struct Planner {
   const Instance* ins;
   const Deadline* deadline;
   std::mt19937* MT;
   const int verbose;
-  const int FLG_SWAP = 0;
 
   // hyper parameters
   const Objective objective;
   const float RESTART_RATE;  // random restart
+  const PlannerOptions options;
 
   // solver utils
   const uint N;       // number of agents
   const uint V_size;  // number o vertices
-  DistTable D;
+  DistTable* const D_owned;  // nullptr when given
+  DistTable& D;
   uint loop_cnt;      // auxiliary
+  uint num_node_compacted;
 
-  // used in PIBT
-  std::vector<std::array<Vertex*, 5> > C_next;  // next locations, used in PIBT
-  std::vector<float> tie_breakers;              // random values, used in PIBT
-  Agents A;
-  Agents occupied_now;                          // for quick collision checking
-  Agents occupied_next;                         // for quick collision checking
+  // configuration generators, workers[0] is also used in the sequential mode
+  std::vector<std::mt19937> MTs;  // random seeds for workers[1..]
+  std::vector<PIBT*> workers;
+  ThreadPool* pool;
+
+  // external memory
+  ColdStore* cold;
+  std::deque<HNode*> hot_nodes;  // spill candidates, older first
+
+  // hardware counters of the calling thread, see PerfPhase
+  PerfCounters perf;
+
+  // congestion metrics from PIBT are added when given
+  Heatmap* heatmap;
 
   Planner(const Instance* _ins, const Deadline* _deadline, std::mt19937* _MT,
           const int _verbose = 0,
           // other parameters
           const Objective _objective = OBJ_NONE,
-          const float _restart_rate = 0.001);
+          const float _restart_rate = 0.001,
+          // reused distance table, rows extended to ins
+          DistTable* _D = nullptr,
+          const PlannerOptions& _options = PlannerOptions());
   ~Planner();
   Solution solve(std::string& additional_info);
   void expand_lowlevel_tree(HNode* H, LNode* L);
-  void rewrite(HNode* H_from, HNode* T, HNode* H_goal,
+  void compact(Explored<HNode>& EXPLORED, HNode* H_goal);
+  bool spill(Explored<HNode>& EXPLORED);  // false: spilling has failed
+  bool load(Explored<HNode>& EXPLORED, HNode* H);  // false: read failure
+  HNode* find_cold(const Config& C);
+  void rewrite(HNode* H_from, HNode* T, const uint cost, HNode* H_goal,
                std::stack<HNode*>& OPEN);
   uint get_edge_cost(const Config& C1, const Config& C2);
   uint get_edge_cost(HNode* H_from, HNode* H_to);
   uint get_h_value(const Config& C);
   //float h(uint i, Vertex* v, HNode* H);
-  bool get_new_config(HNode* H, LNode* L);
-  bool funcPIBT(Agent* ai);
-
-  // swap operation
-  Agent* swap_possible_and_required(Agent* ai);
-  bool is_swap_required(const uint pusher, const uint puller,
-                        Vertex* v_pusher_origin, Vertex* v_puller_origin);
-  bool is_swap_possible(Vertex* v_pusher_origin, Vertex* v_puller_origin);
 
   // utilities
   template <typename... Body>
   void solver_info(const int level, Body&&... body)
   {
     if (verbose < level) return;
-    std::cout << "elapsed:" << std::setw(6) << elapsed_ms(deadline) << "ms"
-              << "  loop_cnt:" << std::setw(8) << loop_cnt
-              << "  node_cnt:" << std::setw(8) << HNode::HNODE_CNT << "\t";
-    info(level, verbose, (body)...);
+    info(level, verbose, "elapsed:", std::setw(6), elapsed_ms(deadline), "ms",
+         "  loop_cnt:", std::setw(8), loop_cnt, "  node_cnt:", std::setw(8),
+         HNode::HNODE_CNT.load(), "\t", (body)...);
   }
 };
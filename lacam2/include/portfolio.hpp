@@ -0,0 +1,59 @@
+/*
+ * portfolio of solver processes over TCP, loopback by default
+ *
+ * the coordinator hands out configurations to workers, collects solutions
+ * and broadcasts cancellation; workers either are forked locally or
+ * connect on their own, e.g., `main ... --worker host:port`
+ * each worker loads the same instance by itself
+ *
+ * protocol, one line per message:
+ *   worker -> coordinator: HELLO
+ *   coordinator -> worker: SOLVE <id> <seed> <restart rate> <objective> <ms>
+ *   worker -> coordinator: RESULT <id> <solved> <comp_time_ms> <T> <N>
+ *                          followed by T * N cell indexes on the same line
+ *   coordinator -> worker: CANCEL (current job), BYE (exit)
+ */
+#pragma once
+#include "instance.hpp"
+#include "planner.hpp"
+#include "utils.hpp"
+
+enum PortfolioMode { PORTFOLIO_FIRST, PORTFOLIO_BEST };
+
+struct PortfolioConfig {
+  int seed;
+  float restart_rate;
+  Objective objective;
+};
+
+struct Portfolio {
+  const Instance& ins;
+  const std::vector<PortfolioConfig> configs;
+  const PortfolioMode mode;
+  int port;  // listening port, 0 -> any free port
+  const int verbose;
+  const PlannerOptions options;  // of local workers
+
+  // results
+  Solution solution;
+  int winner;  // config, -1 -> none
+  uint num_results;
+  uint num_workers;  // connected so far
+
+  Portfolio(const Instance& _ins, const std::vector<PortfolioConfig>& _configs,
+            const PortfolioMode _mode, const int _port = 0,
+            const int _verbose = 0,
+            const PlannerOptions& _options = PlannerOptions());
+
+  // forks num_local workers, then serves until done or the deadline;
+  // PORTFOLIO_BEST ranks by the objective of configs[0],
+  // makespan for OBJ_MAKESPAN, otherwise sum of loss
+  Solution coordinate(const Deadline* deadline, const uint num_local,
+                      std::string& additional_info);
+  bool is_better(const Solution& a, const Solution& b) const;
+};
+
+// worker: connects to host:port and solves until BYE; 0 on success
+int portfolio_worker(const Instance& ins, const std::string& host,
+                     const int port, const int verbose = 0,
+                     const PlannerOptions& options = PlannerOptions());
@@ -8,6 +8,8 @@
 
 bool is_feasible_solution(uint& offgoals, uint& badmoves, const Instance& ins, const Solution& solution,
                           const int verbose = 0);
+bool is_feasible_solution(const Instance& ins, const Solution& solution,
+                          const int verbose = 0);
 int get_makespan(const Solution& solution);
 int get_path_cost(const Solution& solution, uint i);  // single-agent path cost
 int get_sum_of_costs(const Solution& solution);
@@ -16,9 +18,46 @@ int get_makespan_lower_bound(const Instance& ins, DistTable& D);
 int get_sum_of_costs_lower_bound(const Instance& ins, DistTable& D);
 void print_stats(const int verbose, const Instance& ins,
                  const Solution& solution, const double comp_time_ms);
+// key=value lines of make_log, without locations
+std::string get_log_stats(const Instance& ins, const Solution& solution,
+                          const double comp_time_ms,
+                          const std::string& map_name, const int seed,
+                          const std::string& additional_info);
 void make_log(const Instance& ins, const Solution& solution,
               const std::string& output_name, const double comp_time_ms,
               const std::string& map_name, const int seed,
               const std::string& additional_info,
               const bool log_short = false  // true -> paths not appear
 );
+// with stats by get_log_stats
+void make_log(const Instance& ins, const Solution& solution,
+              const std::string& output_name, const std::string& stats,
+              const bool log_short = false);
+
+// the same as make_log as one JSON object per line, numbers unquoted,
+// with timing breakdowns in ms; append=true gives JSONL for batch runs
+void make_json_log(
+    const Instance& ins, const Solution& solution,
+    const std::string& output_name, const std::string& stats,
+    const std::vector<std::pair<std::string, double> >& timings = {},
+    const bool log_short = false, const bool append = false);
+
+// solution section of a result file by make_log, empty if unavailable
+Solution load_solution(const Instance& ins, const std::string& filename);
+
+// per-agent changes between two solutions, for replanning cycles
+// agents stay at their last location after the end of a solution
+struct PathDiff {
+  uint agent;
+  uint t_diverge;  // first timestep where the new path differs
+  Config suffix;   // new locations from t_diverge until the last move
+};
+struct SolutionDiff {
+  uint T;                       // length of the new solution
+  uint N;                       // agents of the new solution
+  std::vector<PathDiff> paths;  // changed agents only, ascending
+};
+SolutionDiff get_solution_diff(const Solution& prev, const Solution& next);
+Solution apply_solution_diff(const Solution& prev, const SolutionDiff& diff);
+void make_diff_log(const Instance& ins, const SolutionDiff& diff,
+                   const std::string& output_name);
@@ -0,0 +1,36 @@
+/*
+ * replanning a subset of agents against the fixed paths of the rest
+ * prioritized planning with space-time A* over a reservation table
+ */
+#pragma once
+#include "instance.hpp"
+#include "utils.hpp"
+
+// space-time occupancy of committed paths
+// agents stay at their last location after the end of their paths
+struct ReservationTable {
+  const uint V_size;
+  // per vertex, (t, vertex id at t + 1) sorted by t, for vertex/swap conflicts
+  std::vector<std::vector<std::pair<uint, uint> > > entries;
+  std::vector<uint> rest_from;  // occupied forever from, UINT_MAX: never
+  std::vector<uint> last_use;   // last timestep of temporary occupancy + 1
+  uint T;                       // length of the longest path
+
+  ReservationTable(const uint _V_size);
+  void add(const Config& path);  // path[t], t = 0, 1, ...
+  bool is_occupied(const uint t, const Vertex* v) const;
+  uint get_next(const uint t, const Vertex* v) const;  // UINT_MAX: free
+  // moving from -> to during t -> t + 1
+  bool is_valid_move(const uint t, const Vertex* from, const Vertex* to) const;
+};
+
+// single-agent path from s to g, staying at g forever; empty on failure
+Config get_space_time_path(const Graph& G, const ReservationTable& RT,
+                           Vertex* s, Vertex* g,
+                           const Deadline* deadline = nullptr);
+
+// plans agents[k] from solution[0] to new_goals[k], in this order;
+// others keep their paths; merged solution, or empty on failure
+Solution replan(const Instance& ins, const Solution& solution,
+                const std::vector<uint>& agents, const Config& new_goals,
+                const Deadline* deadline = nullptr, const int verbose = 0);
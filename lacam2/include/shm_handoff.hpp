@@ -0,0 +1,62 @@
+/*
+ * zero-copy solution handoff to another process via POSIX shared memory
+ *
+ * layout: ShmHeader, then solution as uint32 cell indexes (width * y + x),
+ * row-major [timestep][agent]
+ * either side may create the segment; a zero-filled header means empty
+ * the segment can be published repeatedly: `state` is SHM_EMPTY while being
+ * written, and each completed publish bumps the futex word `generation`
+ */
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+#include "instance.hpp"
+#include "utils.hpp"
+
+enum ShmState : uint32_t { SHM_EMPTY = 0, SHM_READY = 1, SHM_FAILED = 2 };
+
+struct ShmHeader {
+  static constexpr uint32_t MAGIC = 0x4853434c;  // "LCSH"
+
+  std::atomic<uint32_t> state;       // ShmState
+  std::atomic<uint32_t> generation;  // futex word, #(completed publishes)
+  uint32_t magic;
+  uint32_t N;       // agents
+  uint32_t T;       // number of configurations, 0 when failed
+  uint32_t width;   // grid
+  uint32_t height;
+  double comp_time_ms;
+  uint64_t data_offset;  // bytes from the beginning of the segment
+  uint64_t size;         // bytes of the segment
+};
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+
+struct ShmSegment {
+  const std::string name;  // e.g., "/lacam2_result"
+  int fd;
+  void* addr;
+  size_t size;  // mapped bytes
+  uint32_t seen;  // generation returned by the last wait()
+
+  ShmSegment(const std::string& _name);  // opens or creates
+  ~ShmSegment();
+
+  bool is_open() const;
+  bool map(const size_t _size);  // grows the segment if smaller
+  ShmHeader* header() const;
+  void unlink();
+
+  // writer: marks a previous result as outdated, e.g., before a new search
+  void invalidate();
+  // writer: solution and ShmHeader, then wakes waiting clients
+  bool publish(const Instance& ins, const Solution& solution,
+               const double comp_time_ms);
+
+  // client: blocks until a publish newer than the last wait() completes,
+  // maps the whole segment; data stay valid until the next publish
+  // false on timeout, timeout_ms < 0 -> no timeout
+  bool wait(const int timeout_ms = -1);
+  const uint32_t* data() const;                // after wait()
+  uint32_t get(const uint t, const uint i) const;  // cell index
+};
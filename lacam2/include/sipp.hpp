@@ -0,0 +1,35 @@
+/*
+ * safe interval path planning (SIPP) for a single agent
+ * c.f., Phillips & Likhachev, ICRA-11
+ *
+ * safe intervals are derived from a ReservationTable and stored per vertex
+ * in a flat array; heuristics are rows of a DistTable
+ */
+#pragma once
+#include "dist_table.hpp"
+#include "graph.hpp"
+#include "replan.hpp"
+#include "utils.hpp"
+
+struct SIPP {
+  const Graph& G;
+  const ReservationTable& RT;  // for swap conflicts
+  // safe intervals [begin, end) of vertex v: offsets[v] .. offsets[v + 1]
+  // end == UINT_MAX: safe forever
+  std::vector<uint> offsets;
+  std::vector<std::pair<uint, uint> > intervals;
+
+  // search data, indexed by interval, reset lazily by stamps
+  std::vector<uint> g_best;
+  std::vector<uint> stamps;
+  uint stamp;
+  uint64_t num_expanded;
+
+  SIPP(const Graph& _G, const ReservationTable& _RT);
+
+  // path from s to the goal of row i of D, staying there forever;
+  // empty on failure
+  Config find_path(Vertex* s, DistTable& D, const uint i,
+                   const Deadline* deadline = nullptr);
+  size_t memory_usage() const;  // bytes of safe intervals
+};
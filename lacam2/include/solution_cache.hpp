@@ -0,0 +1,41 @@
+/*
+ * solution cache for repeated identical queries
+ * key: map, starts, goals and objective
+ */
+#pragma once
+#include <list>
+
+#include "instance.hpp"
+#include "planner.hpp"
+#include "utils.hpp"
+
+// identify a query, independent of vertex addresses
+uint64_t get_instance_hash(const Instance& ins, const Objective objective);
+
+struct SolutionCache {
+  // solution as a flat sequence of vertex indices (Graph::U), time-major
+  struct Entry {
+    uint64_t key;
+    uint N;
+    std::vector<uint> path;
+  };
+
+  const size_t capacity;        // max #entries kept in memory
+  const std::string cache_dir;  // on-disk store, empty -> memory only
+  uint hit_cnt;
+  uint miss_cnt;
+
+  std::list<Entry> entries;  // LRU order, front is most recently used
+  std::unordered_map<uint64_t, std::list<Entry>::iterator> table;
+
+  SolutionCache(const size_t _capacity = 256,
+                const std::string& _cache_dir = "");
+
+  // true when a validated solution is found, written to solution
+  bool find(const Instance& ins, const Objective objective, Solution& solution,
+            const int verbose = 0);
+  void insert(const Instance& ins, const Objective objective,
+              const Solution& solution);
+  void erase(const uint64_t key);
+  void touch(Entry&& entry);  // insert as the most recently used
+};
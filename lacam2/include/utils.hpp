@@ -4,11 +4,17 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <chrono>
 #include <climits>
+#include <condition_variable>
+#include <deque>
 #include <fstream>
+#include <functional>
 #include <iomanip>
 #include <iostream>
+#include <map>
+#include <mutex>
 #include <numeric>
 #include <queue>
 #include <random>
@@ -16,30 +22,35 @@
 #include <set>
 #include <stack>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
-using Time = std::chrono::steady_clock;
+#include "logger.hpp"
 
-void info(const int level, const int verbose);
+using Time = std::chrono::steady_clock;
 
-template <typename Head, typename... Tail>
-void info(const int level, const int verbose, Head&& head, Tail&&... tail)
+// one line, see Logger for the output
+template <typename... Body>
+void info(const int level, const int verbose, Body&&... body)
 {
   if (verbose < level) return;
-  std::cout << head;
-  info(level, verbose, std::forward<Tail>(tail)...);
+  (Logger::begin() << ... << body);
+  Logger::end();
 }
 
 // time manager
 struct Deadline {
   const Time::time_point t_s;
   const double time_limit_ms;
+  mutable std::atomic<bool> cancelled;  // expired early, from any thread
 
   Deadline(double _time_limit_ms = 0);
   double elapsed_ms() const;
   double elapsed_ns() const;
+  void cancel() const;
 };
 
 double elapsed_ms(const Deadline* deadline);
@@ -48,3 +59,44 @@ bool is_expired(const Deadline* deadline);
 
 float get_random_float(std::mt19937* MT, float from = 0, float to = 1);
 int get_random_int(std::mt19937* MT, int from = 0, int to = 1);
+
+// counts of small non-negative integers, the last bin collects the rest
+struct Histogram {
+  std::vector<uint64_t> bins;
+  size_t max_bin;
+
+  Histogram(const size_t _max_bin = 64);
+  void add(const size_t val);
+  void merge(const Histogram& other);
+  uint64_t total() const;
+  double mean() const;
+  std::string str() const;  // comma-separated counts, from zero
+};
+
+// fork-join over persistent threads, the caller also works
+struct ThreadPool {
+  std::vector<std::thread> threads;
+  std::mutex mtx;
+  std::condition_variable cv_start;
+  std::condition_variable cv_done;
+  const std::function<void(size_t)>* job;
+  size_t num_jobs;
+  std::atomic<size_t> next_job;
+  size_t num_finished;  // #(threads) done with the current generation
+  uint generation;
+  bool each;  // one job per thread, job id = worker id
+  bool stop;
+
+  ThreadPool(const size_t num_threads);  // including the caller
+  ~ThreadPool();
+  size_t size() const;
+  void run(const size_t n, const std::function<void(size_t)>& f);  // f(0..n-1)
+  // f(k) on worker k, the caller is worker 0; e.g., for thread-local setup
+  void run_each(const std::function<void(size_t)>& f);
+  // f(k) on worker k for k < n <= size(), others stay idle;
+  // keeps per-worker data on the node of the worker
+  void run_bound(const size_t n, const std::function<void(size_t)>& f);
+  void dispatch(const size_t n, const std::function<void(size_t)>& f,
+                const bool _each);
+  void work(const size_t worker_id);
+};
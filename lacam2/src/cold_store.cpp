@@ -0,0 +1,450 @@
+#include "../include/cold_store.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <filesystem>
+#include <sstream>
+#include <tuple>
+
+static void put_varint(std::string& buf, uint64_t val)
+{
+  while (val >= 0x80) {
+    buf.push_back((char)(val | 0x80));
+    val >>= 7;
+  }
+  buf.push_back((char)val);
+}
+
+static uint64_t get_varint(const char*& p)
+{
+  uint64_t val = 0;
+  for (int shift = 0;; shift += 7) {
+    const auto b = (unsigned char)*(p++);
+    val |= (uint64_t)(b & 0x7f) << shift;
+    if (b < 0x80) return val;
+  }
+}
+
+static void put_fixed(std::string& buf, const uint64_t val)
+{
+  buf.append((const char*)&val, sizeof(val));
+}
+
+static uint64_t get_fixed(const char*& p)
+{
+  uint64_t val;
+  std::memcpy(&val, p, sizeof(val));
+  p += sizeof(val);
+  return val;
+}
+
+// double hashing for the Bloom filter
+static uint64_t get_bloom_pos(const uint64_t fp, const size_t k,
+                              const size_t num_bits)
+{
+  const uint64_t h2 = (fp * 0xff51afd7ed558ccdULL) | 1;
+  return (fp + k * h2) % num_bits;
+}
+
+static constexpr size_t IO_CHUNK = 1 << 20;  // bytes, buffered I/O
+static constexpr size_t ID_ENTRY = 16;         // bytes, id and fingerprint
+
+// sequential writer of a new run: records in (fingerprint, id) order,
+// then ids in order
+struct RunWriter {
+  ColdStore::Run* run;
+  std::string buf;
+  uint64_t offset;  // of buf in the file
+  size_t num_ids;
+  bool ok;
+
+  RunWriter(ColdStore::Run* _run, const size_t capacity)
+      : run(_run), buf(), offset(0), num_ids(0), ok(_run->fd >= 0)
+  {
+    run->num_records = 0;
+    run->num_bits = std::max((size_t)64, ColdStore::BLOOM_BITS * capacity);
+    run->bloom.assign((run->num_bits + 63) / 64, 0);
+    run->id_last = 0;
+  }
+
+  uint64_t tell() const { return offset + buf.size(); }
+
+  void flush()
+  {
+    for (size_t written = 0; ok && written < buf.size();) {
+      const auto res = pwrite(run->fd, buf.data() + written,
+                              buf.size() - written, offset + written);
+      ok = (res > 0);
+      if (ok) written += res;
+    }
+    offset += buf.size();
+    buf.clear();
+  }
+
+  void add_record(const uint64_t fp, const uint64_t id, const char* body,
+                  const size_t len)
+  {
+    if (run->num_records % ColdStore::BLOCK_SIZE == 0) {
+      run->index_fp.push_back(fp);
+      run->index_offset.push_back(tell());
+    }
+    for (size_t k = 0; k < ColdStore::BLOOM_HASHES; ++k) {
+      const auto pos = get_bloom_pos(fp, k, run->num_bits);
+      run->bloom[pos / 64] |= (uint64_t)1 << (pos % 64);
+    }
+    put_fixed(buf, fp);
+    put_fixed(buf, id);
+    buf.append(body, len);
+    ++run->num_records;
+    if (buf.size() >= IO_CHUNK) flush();
+  }
+
+  void begin_ids()
+  {
+    run->id_begin = tell();
+    run->index_offset.push_back(run->id_begin);
+  }
+
+  void add_id(const uint64_t id, const uint64_t fp)
+  {
+    if (num_ids % ColdStore::BLOCK_SIZE == 0) run->index_id.push_back(id);
+    run->id_last = id;
+    put_fixed(buf, id);
+    put_fixed(buf, fp);
+    ++num_ids;
+    if (buf.size() >= IO_CHUNK) flush();
+  }
+
+  bool finish()
+  {
+    flush();
+    run->size = offset;
+    return ok;
+  }
+};
+
+// sequential reader of a section [pos, end) of a run
+struct RunReader {
+  const ColdStore::Run* run;
+  const uint N;
+  uint64_t pos;
+  const uint64_t end;
+  std::string buf;
+  size_t head;  // consumed bytes of buf
+  bool ok;      // false after a read error
+
+  RunReader(const ColdStore::Run* _run, const uint _N, const uint64_t begin,
+            const uint64_t _end)
+      : run(_run), N(_N), pos(begin), end(_end), buf(), head(0), ok(true)
+  {
+  }
+
+  size_t available() const { return buf.size() - head; }
+
+  // buffers at least len bytes unless the section ends
+  void fill(const size_t len)
+  {
+    if (!ok || available() >= len || pos >= end) return;
+    buf.erase(0, head);
+    head = 0;
+    const auto n = std::min((uint64_t)std::max(IO_CHUNK, len), end - pos);
+    const auto old_size = buf.size();
+    buf.resize(old_size + n);
+    if (pread(run->fd, buf.data() + old_size, n, pos) != (ssize_t)n) {
+      buf.resize(old_size);
+      ok = false;
+      return;
+    }
+    pos += n;
+  }
+
+  // body points into the buffer, valid until the next call
+  bool next_record(uint64_t& fp, uint64_t& id, const char*& body,
+                   size_t& len)
+  {
+    fill(16 + 10 * (size_t)N);
+    if (!ok || available() < 16) return false;
+    const char* p = buf.data() + head;
+    fp = get_fixed(p);
+    id = get_fixed(p);
+    body = p;
+    for (size_t i = 0; i < N; ++i) get_varint(p);
+    len = p - body;
+    head += 16 + len;
+    return true;
+  }
+
+  bool next_id(uint64_t& id, uint64_t& fp)
+  {
+    fill(ID_ENTRY);
+    if (!ok || available() < ID_ENTRY) return false;
+    const char* p = buf.data() + head;
+    id = get_fixed(p);
+    fp = get_fixed(p);
+    head += ID_ENTRY;
+    return true;
+  }
+};
+
+ColdStore::ColdStore(const std::string& _dir, const Vertices& _V,
+                     const uint _N)
+    : dir(_dir),
+      V(_V),
+      N(_N),
+      runs(),
+      next_run(0),
+      num_spilled(0),
+      num_merges(0),
+      num_block_reads(0),
+      num_bloom_rejects(0)
+{
+  std::error_code ec;
+  std::filesystem::create_directories(dir, ec);
+}
+
+ColdStore::~ColdStore()
+{
+  for (auto run : runs) remove_run(run);
+}
+
+uint64_t ColdStore::get_fingerprint(const Config& C)
+{
+  // FNV-1a over vertex ids, finalized by a mixer
+  uint64_t hash = 0xcbf29ce484222325;
+  for (auto v : C) {
+    hash ^= v->id;
+    hash *= 0x100000001b3;
+  }
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+ColdStore::Run* ColdStore::create_run()
+{
+  auto run = new Run();
+  std::stringstream ss;
+  ss << dir << "/run_" << getpid() << "_" << this << "_" << next_run++
+     << ".bin";
+  run->filename = ss.str();
+  run->fd = open(run->filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  return run;
+}
+
+void ColdStore::remove_run(Run* run)
+{
+  if (run->fd >= 0) {
+    close(run->fd);
+    std::remove(run->filename.c_str());
+  }
+  delete run;
+}
+
+bool ColdStore::spill(
+    const std::vector<std::pair<uint64_t, const Config*> >& entries)
+{
+  if (entries.empty()) return true;
+
+  // (fingerprint, id, entry)
+  auto records = std::vector<std::tuple<uint64_t, uint64_t, size_t> >();
+  for (size_t k = 0; k < entries.size(); ++k) {
+    records.emplace_back(get_fingerprint(*entries[k].second), entries[k].first,
+                         k);
+  }
+  std::sort(records.begin(), records.end());
+
+  // write, the store is left unchanged on failure
+  auto run = create_run();
+  auto writer = RunWriter(run, records.size());
+  auto body = std::string();
+  for (auto& [fp, id, k] : records) {
+    body.clear();
+    for (auto v : *entries[k].second) put_varint(body, v->id);
+    writer.add_record(fp, id, body.data(), body.size());
+  }
+  writer.begin_ids();
+  auto ids = std::vector<std::pair<uint64_t, uint64_t> >();
+  for (auto& [fp, id, k] : records) ids.emplace_back(id, fp);
+  std::sort(ids.begin(), ids.end());
+  for (auto& [id, fp] : ids) writer.add_id(id, fp);
+  if (!writer.finish()) {
+    remove_run(run);
+    return false;
+  }
+  runs.push_back(run);
+  num_spilled += entries.size();
+  merge_runs();
+  return true;
+}
+
+ColdStore::Run* ColdStore::merge(const Run* older, const Run* newer)
+{
+  auto run = create_run();
+  auto writer = RunWriter(run, older->num_records + newer->num_records);
+
+  // records, the same id in both runs is kept once
+  auto r_old = RunReader(older, N, 0, older->id_begin);
+  auto r_new = RunReader(newer, N, 0, newer->id_begin);
+  uint64_t fp_old = 0, id_old = 0, fp_new = 0, id_new = 0;
+  const char *body_old = nullptr, *body_new = nullptr;
+  size_t len_old = 0, len_new = 0;
+  auto has_old = r_old.next_record(fp_old, id_old, body_old, len_old);
+  auto has_new = r_new.next_record(fp_new, id_new, body_new, len_new);
+  while (has_old || has_new) {
+    if (has_new && (!has_old || std::make_pair(fp_new, id_new) <=
+                                    std::make_pair(fp_old, id_old))) {
+      writer.add_record(fp_new, id_new, body_new, len_new);
+      if (has_old && fp_old == fp_new && id_old == id_new) {
+        has_old = r_old.next_record(fp_old, id_old, body_old, len_old);
+      }
+      has_new = r_new.next_record(fp_new, id_new, body_new, len_new);
+    } else {
+      writer.add_record(fp_old, id_old, body_old, len_old);
+      has_old = r_old.next_record(fp_old, id_old, body_old, len_old);
+    }
+  }
+
+  // ids
+  writer.begin_ids();
+  auto i_old = RunReader(older, N, older->id_begin, older->size);
+  auto i_new = RunReader(newer, N, newer->id_begin, newer->size);
+  has_old = i_old.next_id(id_old, fp_old);
+  has_new = i_new.next_id(id_new, fp_new);
+  while (has_old || has_new) {
+    if (has_new && (!has_old || id_new <= id_old)) {
+      writer.add_id(id_new, fp_new);
+      if (has_old && id_old == id_new) has_old = i_old.next_id(id_old, fp_old);
+      has_new = i_new.next_id(id_new, fp_new);
+    } else {
+      writer.add_id(id_old, fp_old);
+      has_old = i_old.next_id(id_old, fp_old);
+    }
+  }
+
+  if (!writer.finish() || !r_old.ok || !r_new.ok || !i_old.ok || !i_new.ok) {
+    remove_run(run);
+    return nullptr;
+  }
+  return run;
+}
+
+void ColdStore::merge_runs()
+{
+  // each record is rewritten O(log) times
+  while (runs.size() >= 2) {
+    const auto older = runs[runs.size() - 2];
+    const auto newer = runs.back();
+    if (older->num_records > newer->num_records) break;
+    // keep both on failure, e.g., disk full
+    const auto run = merge(older, newer);
+    if (run == nullptr) break;
+    remove_run(older);
+    remove_run(newer);
+    runs.pop_back();
+    runs.back() = run;
+    ++num_merges;
+  }
+}
+
+bool ColdStore::search(const Run* run, const uint64_t fp, const Config* C,
+                       uint64_t& id, Config* out)
+{
+  // the last block starting at or before fp
+  auto itr = std::upper_bound(run->index_fp.begin(), run->index_fp.end(), fp);
+  if (itr == run->index_fp.begin()) return false;
+  auto b = (size_t)(itr - run->index_fp.begin()) - 1;
+  while (b > 0 && run->index_fp[b] == fp) --b;  // fp may span blocks
+
+  // scan blocks while fingerprints do not exceed fp
+  auto buf = std::string();
+  for (; b + 1 < run->index_offset.size(); ++b) {
+    const auto offset = run->index_offset[b];
+    buf.resize(run->index_offset[b + 1] - offset);
+    if (pread(run->fd, buf.data(), buf.size(), offset) != (ssize_t)buf.size())
+      return false;
+    ++num_block_reads;
+    const char* p = buf.data();
+    const char* end = buf.data() + buf.size();
+    while (p < end) {
+      const auto fp_rec = get_fixed(p);
+      const auto id_rec = get_fixed(p);
+      if (fp_rec > fp) return false;
+      const auto body = p;
+      auto same = (fp_rec == fp && (C != nullptr || id_rec == id));
+      for (size_t i = 0; i < N; ++i) {
+        const auto v_id = get_varint(p);
+        if (same && C != nullptr && (*C)[i]->id != v_id) same = false;
+      }
+      if (!same) continue;
+      id = id_rec;
+      if (out != nullptr) {
+        out->clear();
+        for (const char* q = body; q < p;) out->push_back(V[get_varint(q)]);
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ColdStore::find(const Config& C, uint64_t& id)
+{
+  const auto fp = get_fingerprint(C);
+
+  // newer runs first
+  for (int r = runs.size() - 1; r >= 0; --r) {
+    const auto run = runs[r];
+    auto maybe = true;
+    for (size_t k = 0; k < BLOOM_HASHES && maybe; ++k) {
+      const auto pos = get_bloom_pos(fp, k, run->num_bits);
+      maybe = (run->bloom[pos / 64] >> (pos % 64)) & 1;
+    }
+    if (!maybe) {
+      ++num_bloom_rejects;
+      continue;
+    }
+    if (search(run, fp, &C, id, nullptr)) return true;
+  }
+  return false;
+}
+
+bool ColdStore::read(const uint64_t id, Config& C)
+{
+  auto buf = std::string();
+  for (int r = runs.size() - 1; r >= 0; --r) {
+    const auto run = runs[r];
+    if (run->index_id.empty() || id < run->index_id.front() ||
+        id > run->id_last)
+      continue;
+
+    // block of the id section
+    const auto itr =
+        std::upper_bound(run->index_id.begin(), run->index_id.end(), id);
+    const auto b = (size_t)(itr - run->index_id.begin()) - 1;
+    const auto offset = run->id_begin + b * BLOCK_SIZE * ID_ENTRY;
+    buf.resize(std::min(BLOCK_SIZE * ID_ENTRY, run->size - offset));
+    if (pread(run->fd, buf.data(), buf.size(), offset) != (ssize_t)buf.size())
+      return false;
+    ++num_block_reads;
+    for (const char* p = buf.data(); p < buf.data() + buf.size();) {
+      const auto id_rec = get_fixed(p);
+      const auto fp = get_fixed(p);
+      if (id_rec < id) continue;
+      if (id_rec > id) break;
+      // the record must exist, anything else is a read failure
+      auto id_found = id;
+      return search(run, fp, nullptr, id_found, &C);
+    }
+  }
+  return false;
+}
+
+size_t ColdStore::disk_usage() const
+{
+  size_t size = 0;
+  for (auto run : runs) size += run->size;
+  return size;
+}
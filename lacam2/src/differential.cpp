@@ -0,0 +1,333 @@
+#include "../include/differential.hpp"
+
+#include <sstream>
+
+#include "../include/lacam2.hpp"
+
+std::vector<uint> get_reference_distances(const Graph& G, Vertex* goal)
+{
+  const auto V_size = G.size();
+  auto dist = std::vector<uint>(V_size, V_size);
+  auto OPEN = std::queue<Vertex*>();
+  dist[goal->id] = 0;
+  OPEN.push(goal);
+  while (!OPEN.empty()) {
+    auto n = OPEN.front();
+    OPEN.pop();
+    for (auto m : n->in_neighbor) {
+      if (dist[m->id] != V_size) continue;
+      dist[m->id] = dist[n->id] + 1;
+      OPEN.push(m);
+    }
+  }
+  return dist;
+}
+
+ReferencePIBT::ReferencePIBT(const Instance* _ins, std::mt19937* _MT)
+    : ins(_ins),
+      MT(_MT),
+      N(ins->N),
+      dist(),
+      tie_breakers(ins->G.size(), 0),
+      occupied_now(),
+      occupied_next(),
+      C_now(),
+      C_next()
+{
+  for (auto g : ins->goals) dist.push_back(get_reference_distances(ins->G, g));
+}
+
+bool ReferencePIBT::get_new_config(
+    const Config& C, const std::vector<uint>& order,
+    const std::vector<std::pair<uint, Vertex*> >& constraints)
+{
+  C_now = C;
+  C_next.assign(N, nullptr);
+  occupied_now.assign(ins->G.size(), -1);
+  occupied_next.assign(ins->G.size(), -1);
+  for (uint i = 0; i < N; ++i) occupied_now[C[i]->id] = i;
+
+  for (auto& [i, v] : constraints) {
+    if (occupied_next[v->id] != -1) return false;  // vertex conflict
+    const auto j = occupied_next[C[i]->id];
+    if (j != -1 && occupied_now[v->id] == j) return false;  // swap conflict
+    C_next[i] = v;
+    occupied_next[v->id] = i;
+  }
+
+  for (auto i : order) {
+    if (C_next[i] != nullptr) continue;
+    if (!funcPIBT(i)) return false;
+  }
+  return true;
+}
+
+bool ReferencePIBT::funcPIBT(const uint i)
+{
+  auto candidates = C_now[i]->neighbor;
+  for (auto u : candidates) {
+    if (MT != nullptr) tie_breakers[u->id] = get_random_float(MT);
+  }
+  candidates.push_back(C_now[i]);
+  std::stable_sort(candidates.begin(), candidates.end(),
+                   [&](Vertex* a, Vertex* b) {
+                     return (float)dist[i][a->id] + tie_breakers[a->id] <
+                            (float)dist[i][b->id] + tie_breakers[b->id];
+                   });
+
+  for (auto u : candidates) {
+    if (occupied_next[u->id] != -1) continue;
+    const auto k = occupied_now[u->id];
+    if (k != -1 && C_next[k] == C_now[i]) continue;
+    occupied_next[u->id] = i;
+    C_next[i] = u;
+    if (k != -1 && k != (int)i && C_next[k] == nullptr && !funcPIBT(k)) {
+      continue;
+    }
+    return true;
+  }
+
+  // stay, despite conflicts
+  occupied_next[C_now[i]->id] = i;
+  C_next[i] = C_now[i];
+  return false;
+}
+
+namespace
+{
+
+std::string check_distances(const Instance& ins, std::mt19937& MT,
+                            const std::vector<std::vector<uint> >& ref)
+{
+  const auto V_size = ins.G.size();
+  auto queries = std::vector<std::pair<uint, uint> >();
+  for (uint i = 0; i < ins.N; ++i) {
+    for (uint v = 0; v < V_size; ++v) queries.emplace_back(i, v);
+  }
+  std::shuffle(queries.begin(), queries.end(), MT);
+  std::stringstream ss;
+  auto report = [&](const std::string& name, const uint i, const uint v,
+                    const uint d) {
+    ss << "distance " << name << ": agent " << i << ", vertex "
+       << ins.G.V[v] << ", got " << d << ", expected " << ref[i][v];
+    return ss.str();
+  };
+
+  // exact, lazy in random order
+  auto lazy = DistTable(ins);
+  for (auto [i, v] : queries) {
+    const auto d = lazy.get(i, ins.G.V[v]);
+    if (d != ref[i][v]) return report("lazy", i, v, d);
+  }
+
+  // exact, complete rows by threads
+  auto full = DistTable(ins);
+  auto pool = ThreadPool(2);
+  full.setup_all(&pool);
+  for (auto [i, v] : queries) {
+    const auto d = full.table[(size_t)i * V_size + v];
+    if (d != ref[i][v]) return report("full", i, v, d);
+  }
+
+  // admissible lower bounds
+  auto options = DistOptions();
+  options.mode = DIST_BOUNDED;
+  options.bfs_radius = get_random_int(&MT, 0, 8);
+  options.bfs_budget = get_random_int(&MT, 0, 16);
+  auto bounded = DistTable(ins, options);
+  options.mode = DIST_LANDMARK;
+  auto landmark = DistTable(ins, options);
+  for (auto [i, v] : queries) {
+    const auto d_bounded = bounded.get(i, ins.G.V[v]);
+    if (d_bounded > ref[i][v] || (ref[i][v] == 0 && d_bounded != 0)) {
+      return report("bounded", i, v, d_bounded);
+    }
+    const auto d_landmark = landmark.get(i, ins.G.V[v]);
+    if (d_landmark > ref[i][v] || (ref[i][v] == 0 && d_landmark != 0)) {
+      return report("landmark", i, v, d_landmark);
+    }
+  }
+  return "";
+}
+
+std::string check_pibt(const Instance& ins, const int seed,
+                       const uint num_calls)
+{
+  auto D = DistTable(ins);
+  auto MT_opt = std::mt19937(seed);
+  auto MT_ref = std::mt19937(seed);
+  auto MT_L = std::mt19937(seed + 1);  // constraints
+  auto pibt = PIBT(&ins, D, &MT_opt);
+  auto ref = ReferencePIBT(&ins, &MT_ref);
+
+  // random low-level trees; every 10th call from the root moves on
+  auto H = new HNode(ins.starts, D, nullptr, 0, 0);
+  auto nodes = HNodes({H});
+  auto lnodes = std::vector<LNode*>({H->lnodes.front()});
+  std::stringstream ss;
+  for (uint k = 0; k < num_calls && ss.str().empty(); ++k) {
+    const auto step = k % 10 == 9;
+    auto L = step ? lnodes.front()
+                  : lnodes[get_random_int(&MT_L, 0, lnodes.size() - 1)];
+    if (!step && L->depth < ins.N && get_random_float(&MT_L) < 0.7) {
+      const auto i = H->order[L->depth];
+      const auto& neighbor = H->C[i]->neighbor;
+      const uint r = get_random_int(&MT_L, 0, neighbor.size());
+      L = new LNode(L, i, r < neighbor.size() ? neighbor[r] : H->C[i]);
+      H->lnodes.push_back(L);
+      lnodes.push_back(L);
+    }
+    auto constraints = std::vector<std::pair<uint, Vertex*> >();
+    for (auto n = L; n->depth > 0; n = n->parent) {
+      constraints.emplace_back(n->who, n->where);
+    }
+    std::reverse(constraints.begin(), constraints.end());
+
+    const auto res = pibt.get_new_config(H, L);
+    const auto res_ref = ref.get_new_config(H->C, H->order, constraints);
+    if (res != res_ref) {
+      ss << "pibt: call " << k << ", depth " << L->depth << ", got " << res
+         << ", expected " << res_ref;
+      break;
+    }
+    if (!res) continue;
+    for (uint i = 0; i < ins.N; ++i) {
+      if (pibt.A[i]->v_next == ref.C_next[i]) continue;
+      ss << "pibt: call " << k << ", depth " << L->depth << ", agent " << i
+         << ", got " << pibt.A[i]->v_next << ", expected " << ref.C_next[i];
+      break;
+    }
+    if (step && ss.str().empty()) {
+      H = new HNode(ref.C_next, D, H, H->g + 1, 0);
+      nodes.push_back(H);
+      lnodes.assign(1, H->lnodes.front());
+    }
+  }
+  for (auto n : nodes) delete n;
+  return ss.str();
+}
+
+std::string check_planner(const Instance& ins, const int seed)
+{
+  auto run = [&](const PlannerOptions& options) {
+    auto MT = std::mt19937(seed);
+    const auto deadline = Deadline(1000);
+    auto additional_info = std::string();
+    return solve(ins, additional_info, 0, &deadline, &MT, OBJ_NONE, 0.001,
+                 nullptr, nullptr, nullptr, options);
+  };
+  auto check = [&](const std::string& name, const Solution& solution) {
+    if (is_feasible_solution(ins, solution)) return std::string();
+    return "planner " + name + ": infeasible solution";
+  };
+
+  const auto base = run(PlannerOptions());
+  auto res = check("default", base);
+  if (!res.empty()) return res;
+
+  // same solution, only memory differs
+  auto options = PlannerOptions();
+  options.huge_pages = true;
+  options.dist.huge_pages = true;
+  const auto huge = run(options);
+  if (!base.empty() && !huge.empty() && base != huge) {
+    return "planner huge_pages: different solution";
+  }
+
+  options = PlannerOptions();
+  options.num_threads = 2;
+  res = check("threads", run(options));
+  if (!res.empty()) return res;
+
+  options = PlannerOptions();
+  options.dist.mode = DIST_BOUNDED;
+  res = check("bounded", run(options));
+  if (!res.empty()) return res;
+
+  options.dist.mode = DIST_LANDMARK;
+  return check("landmark", run(options));
+}
+
+}  // namespace
+
+std::string check_differential(const Instance& ins, const int seed,
+                               const uint num_pibt_calls,
+                               const DifferentialCheck& extra)
+{
+  auto ref = std::vector<std::vector<uint> >();
+  for (auto g : ins.goals) ref.push_back(get_reference_distances(ins.G, g));
+  auto MT = std::mt19937(seed);
+  auto res = check_distances(ins, MT, ref);
+  if (res.empty()) res = check_pibt(ins, seed, num_pibt_calls);
+  if (res.empty()) res = check_planner(ins, seed);
+  if (res.empty() && extra) res = extra(ins, seed);
+  return res;
+}
+
+std::string minimize_divergence(const std::string& map_filename,
+                                const Instance& ins, const int seed,
+                                const uint num_pibt_calls,
+                                const DifferentialCheck& extra)
+{
+  auto starts = std::vector<uint>();
+  auto goals = std::vector<uint>();
+  for (uint i = 0; i < ins.N; ++i) {
+    starts.push_back(ins.starts[i]->index);
+    goals.push_back(ins.goals[i]->index);
+  }
+  auto what = check_differential(ins, seed, num_pibt_calls, extra);
+  if (what.empty()) return "";
+
+  // drop chunks of agents, halving the chunk size
+  for (size_t chunk = std::max(starts.size() / 2, (size_t)1); chunk > 0;
+       chunk /= 2) {
+    for (size_t k = 0; k < starts.size() && starts.size() > 1;) {
+      const auto end = std::min(k + chunk, starts.size());
+      auto s = starts;
+      auto g = goals;
+      s.erase(s.begin() + k, s.begin() + end);
+      g.erase(g.begin() + k, g.begin() + end);
+      if (s.empty()) break;
+      const auto sub = Instance(map_filename, s, g);
+      const auto res = check_differential(sub, seed, num_pibt_calls, extra);
+      if (res.empty()) {
+        k = end;
+        continue;
+      }
+      starts = s;
+      goals = g;
+      what = res;
+    }
+  }
+
+  std::stringstream ss;
+  ss << "divergence: " << what << "\nreproducer: Instance(\"" << map_filename
+     << "\", {";
+  for (size_t i = 0; i < starts.size(); ++i) ss << (i ? ", " : "") << starts[i];
+  ss << "}, {";
+  for (size_t i = 0; i < goals.size(); ++i) ss << (i ? ", " : "") << goals[i];
+  ss << "}), seed " << seed;
+  return ss.str();
+}
+
+uint run_differential(const std::string& map_filename,
+                      const uint num_instances, const uint max_N,
+                      const int seed, const int verbose)
+{
+  auto MT = std::mt19937(seed);
+  uint num_divergences = 0;
+  for (uint k = 0; k < num_instances; ++k) {
+    const auto N = get_random_int(&MT, 1, max_N);
+    const auto ins = Instance(map_filename, &MT, N);
+    const auto res = check_differential(ins, seed + k);
+    if (!res.empty()) {
+      ++num_divergences;
+      info(0, verbose, minimize_divergence(map_filename, ins, seed + k));
+    }
+    if ((k + 1) % 100 == 0) {
+      info(1, verbose, "differential: ", k + 1, " instances, ",
+           num_divergences, " divergent");
+    }
+  }
+  return num_divergences;
+}
@@ -1,30 +1,62 @@
 #include "../include/dist_table.hpp"
 
-DistTable::DistTable(const Instance& ins)
-    : V_size(ins.G.V.size()), table(ins.N, std::vector<uint>(V_size, V_size))
+#include "../include/numa_placement.hpp"
+
+DistTable::DistTable(const Instance& ins, const DistOptions& _options)
+    : DistTable(&ins, _options)
 {
-  setup(&ins);
 }
 
-DistTable::DistTable(const Instance* ins)
-    : V_size(ins->G.V.size()), table(ins->N, std::vector<uint>(V_size, V_size))
+DistTable::DistTable(const Instance* ins, const DistOptions& _options)
+    : options(_options),
+      mode(options.mode),
+      V_size(ins->G.V.size()),
+      width(ins->G.width),
+      V(&ins->G.V),
+      table(mode != DIST_LANDMARK ? (size_t)ins->N * V_size : 0, V_size,
+            HugeAllocator<uint>(options.huge_pages)),
+      num_lower_bounds(0)
 {
   setup(ins);
 }
 
 void DistTable::setup(const Instance* ins)
 {
-  for (size_t i = 0; i < ins->N; ++i) {
+  if (mode == DIST_LANDMARK) {
+    goals = ins->goals;
+    landmarks.setup(ins, options.num_landmarks, options.landmark_selection,
+                    options.landmark_radius);
+    return;
+  }
+  for (size_t i = goals.size(); i < ins->N; ++i) {
     OPEN.push_back(std::queue<Vertex*>());
     auto n = ins->goals[i];
+    goals.push_back(n);
     OPEN[i].push(n);
-    table[i][n->id] = 0;
+    table[i * V_size + n->id] = 0;
+  }
+}
+
+void DistTable::extend(const Instance* ins)
+{
+  if (mode == DIST_LANDMARK) {
+    setup(ins);
+    return;
   }
+  size_t k = 0;
+  while (k < goals.size() && k < ins->N && goals[k] == ins->goals[k]) ++k;
+  goals.resize(k);
+  OPEN.resize(k);
+  table.resize(k * V_size);
+  table.resize((size_t)ins->N * V_size, V_size);
+  setup(ins);
 }
 
 uint DistTable::get(uint i, uint v_id)
 {
-  if (table[i][v_id] < V_size) return table[i][v_id];
+  if (mode == DIST_LANDMARK) return landmarks.get(i, v_id);
+  auto row = &table[(size_t)i * V_size];
+  if (row[v_id] < V_size) return row[v_id];
 
   /*
    * BFS with lazy evaluation
@@ -33,16 +65,30 @@ uint DistTable::get(uint i, uint v_id)
    *
    * sidenote:
    * tested RRA* but lazy BFS was much better in performance
+   *
+   * distances to the goal, hence over reverse edges on directed maps
+   *
+   * DIST_BOUNDED: beyond bfs_radius, each query expands at most bfs_budget
+   * vertices and falls back to a lower bound; the frontier resumes later
    */
 
+  auto budget = options.bfs_budget;
   while (!OPEN[i].empty()) {
     auto&& n = OPEN[i].front();
+    if (mode == DIST_BOUNDED && row[n->id] >= options.bfs_radius) {
+      if (budget == 0) {
+        if (row[v_id] < V_size) return row[v_id];  // labeled meanwhile
+        ++num_lower_bounds;
+        return get_lower_bound(i, v_id, row[n->id] + 1);
+      }
+      --budget;
+    }
     OPEN[i].pop();
-    const int d_n = table[i][n->id];
-    for (auto&& m : n->neighbor) {
-      const int d_m = table[i][m->id];
+    const int d_n = row[n->id];
+    for (auto&& m : n->in_neighbor) {
+      const int d_m = row[m->id];
       if (d_n + 1 >= d_m) continue;
-      table[i][m->id] = d_n + 1;
+      row[m->id] = d_n + 1;
       OPEN[i].push(m);
     }
     if (n->id == v_id) return d_n;
@@ -51,3 +97,97 @@ uint DistTable::get(uint i, uint v_id)
 }
 
 uint DistTable::get(uint i, Vertex* v) { return get(i, v->id); }
+
+uint DistTable::get_lower_bound(uint i, uint v_id, uint d_frontier) const
+{
+  // vertices closer than the frontier are already labeled
+  const int a = (*V)[v_id]->index;
+  const int b = goals[i]->index;
+  const int w = width;
+  const uint manhattan = std::abs(a % w - b % w) + std::abs(a / w - b / w);
+  return std::max(manhattan, d_frontier);
+}
+
+uint DistTable::get_row_node(const uint i) const
+{
+  return (size_t)i * Numa::num_nodes() / goals.size();
+}
+
+void DistTable::setup_all(ThreadPool* pool)
+{
+  auto bfs = [&](size_t i) {
+    auto row = &table[i * V_size];
+    while (!OPEN[i].empty()) {
+      auto n = OPEN[i].front();
+      OPEN[i].pop();
+      const int d_n = row[n->id];
+      for (auto&& m : n->in_neighbor) {
+        const int d_m = row[m->id];
+        if (d_n + 1 >= d_m) continue;
+        row[m->id] = d_n + 1;
+        OPEN[i].push(m);
+      }
+    }
+  };
+  if (mode == DIST_LANDMARK) return;  // read-only from the beginning
+  if (pool == nullptr) {
+    for (size_t i = 0; i < OPEN.size(); ++i) bfs(i);
+    return;
+  }
+  const auto num_nodes = (size_t)Numa::num_nodes();
+  if (!options.numa || num_nodes == 1 || pool->size() < num_nodes) {
+    pool->run(OPEN.size(), bfs);
+    return;
+  }
+
+  // NUMA: node-local rows, filled by workers pinned to the node
+  const auto N = OPEN.size();
+  auto block_begin = std::vector<size_t>(num_nodes + 1);  // agents of node j
+  for (size_t j = 0; j <= num_nodes; ++j) {
+    block_begin[j] = (j * N + num_nodes - 1) / num_nodes;
+  }
+  Numa::pin_pool(pool);
+  // blocks do not share whole pages, so they can be moved concurrently
+  pool->run_each([&](size_t k) {
+    if (k >= num_nodes) return;
+    Numa::place(table.data() + block_begin[k] * V_size,
+                (block_begin[k + 1] - block_begin[k]) * V_size * sizeof(uint),
+                k);
+  });
+  // restart BFS from scratch, in rows of the own node
+  const auto num_workers = pool->size();
+  pool->run_each([&](size_t k) {
+    const auto node = Numa::node_of_worker(k);
+    // workers on the node: node, node + num_nodes, ...
+    const auto stride = (num_workers - node + num_nodes - 1) / num_nodes;
+    const auto rank = k / num_nodes;
+    for (auto i = block_begin[node] + rank; i < block_begin[node + 1];
+         i += stride) {
+      std::fill(table.begin() + i * V_size, table.begin() + (i + 1) * V_size,
+                V_size);
+      OPEN[i] = std::queue<Vertex*>();
+      OPEN[i].push(goals[i]);
+      table[i * V_size + goals[i]->id] = 0;
+      bfs(i);
+    }
+  });
+  // threads created later by the caller would inherit node 0
+  Numa::unpin_caller();
+}
+
+size_t DistTable::memory_usage() const
+{
+  return table.size() * sizeof(uint) + landmarks.memory_usage();
+}
+
+std::ostream& operator<<(std::ostream& os, const DistMode mode)
+{
+  if (mode == DIST_BFS) {
+    os << "bfs";
+  } else if (mode == DIST_LANDMARK) {
+    os << "landmark";
+  } else if (mode == DIST_BOUNDED) {
+    os << "bounded";
+  }
+  return os;
+}
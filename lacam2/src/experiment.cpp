@@ -0,0 +1,181 @@
+#include "../include/experiment.hpp"
+
+#include <filesystem>
+#include <map>
+#include <regex>
+
+#include "../include/json.hpp"
+#include "../include/lacam2.hpp"
+
+namespace fs = std::filesystem;
+
+// map name in the first entry of a scenario, empty if none
+static const std::regex r_scen_map = std::regex(R"(\d+\t(.+\.map)\t.+)");
+
+static std::string get_scen_map_name(const std::string& scen_filename)
+{
+  std::ifstream file(scen_filename);
+  std::string line;
+  std::smatch results;
+  while (getline(file, line)) {
+    if (!line.empty() && line.back() == 0x0d) line.pop_back();
+    if (std::regex_match(line, results, r_scen_map)) {
+      return fs::path(results[1].str()).filename().string();
+    }
+  }
+  return "";
+}
+
+Experiment::Experiment(const uint _step, const uint _max_N,
+                       const double _time_limit_ms, const int _seed,
+                       const int _verbose)
+    : step(std::max(_step, (uint)1)),
+      max_N(_max_N),
+      time_limit_ms(_time_limit_ms),
+      seed(_seed),
+      verbose(_verbose),
+      options(),
+      tasks(),
+      runs()
+{
+}
+
+size_t Experiment::find_tasks(const std::string& dir)
+{
+  auto maps = std::map<std::string, std::string>();  // name -> path
+  auto scens = std::vector<std::string>();
+  std::error_code ec;
+  for (auto& entry : fs::recursive_directory_iterator(dir, ec)) {
+    if (!entry.is_regular_file()) continue;
+    const auto& path = entry.path();
+    if (path.extension() == ".map") {
+      maps.emplace(path.filename().string(), path.string());
+    } else if (path.extension() == ".scen") {
+      scens.push_back(path.string());
+    }
+  }
+  if (ec) info(0, verbose, "failed to walk ", dir, ": ", ec.message());
+
+  tasks.clear();
+  for (auto& scen : scens) {
+    const auto itr = maps.find(get_scen_map_name(scen));
+    if (itr == maps.end()) {
+      info(1, verbose, "skip ", scen, ", map not found");
+      continue;
+    }
+    tasks.emplace_back(itr->second, scen);
+  }
+  std::sort(tasks.begin(), tasks.end());
+  return tasks.size();
+}
+
+void Experiment::run(const uint num_threads)
+{
+  auto results = std::vector<std::vector<ExperimentRun> >(tasks.size());
+  auto pool = ThreadPool(num_threads);
+  pool.run(tasks.size(), [&](size_t k) {
+    const auto& [map_filename, scen_filename] = tasks[k];
+    const auto map_name = fs::path(map_filename).filename().string();
+    const auto scen_name = fs::path(scen_filename).filename().string();
+
+    // all agents once, then prefixes sharing the graph and distance rows
+    const auto base =
+        Instance(scen_filename, map_filename, max_N > 0 ? max_N : UINT_MAX);
+    const uint num_agents = base.starts.size();
+    auto D = DistTable(base, options.dist);
+    for (uint N = step; N <= num_agents; N += step) {
+      const auto ins = Instance(base, N);
+      D.extend(&ins);
+      auto MT = std::mt19937(seed);
+      const auto deadline = Deadline(time_limit_ms);
+      auto additional_info = std::string();
+      const auto solution = solve(ins, additional_info, 0, &deadline, &MT,
+                                  OBJ_NONE, 0.001, nullptr, nullptr, &D,
+                                  options);
+      const auto comp_time_ms = deadline.elapsed_ms();
+      const auto solved = !solution.empty() &&
+                          comp_time_ms <= time_limit_ms &&
+                          is_feasible_solution(ins, solution);
+
+      results[k].push_back({map_name, scen_name, N, solved, comp_time_ms,
+                            solved ? get_makespan(solution) : 0,
+                            get_makespan_lower_bound(ins, D),
+                            solved ? get_sum_of_costs(solution) : 0,
+                            get_sum_of_costs_lower_bound(ins, D)});
+      info(1, verbose, scen_name, "\tN=", N, "\tsolved=", solved, "\t",
+           comp_time_ms, "ms");
+      if (!solved) break;
+    }
+  });
+  runs.clear();
+  for (auto& r : results) runs.insert(runs.end(), r.begin(), r.end());
+}
+
+void Experiment::write_runs(const std::string& filename) const
+{
+  std::ofstream log(filename, std::ios::out);
+  if (fs::path(filename).extension() == ".jsonl") {
+    auto json = JsonWriter();
+    for (auto& r : runs) {
+      json.buf.clear();
+      json.begin_object();
+      json.key("map").value(r.map_name).key("scen").value(r.scen_name);
+      json.key("N").value(r.N).key("solved").value(r.solved);
+      json.key("comp_time_ms").value(r.comp_time_ms);
+      json.key("makespan").value(r.makespan);
+      json.key("makespan_lb").value(r.makespan_lb);
+      json.key("sum_of_costs").value(r.sum_of_costs);
+      json.key("sum_of_costs_lb").value(r.sum_of_costs_lb);
+      json.end_object();
+      json.buf.push_back('\n');
+      log.write(json.buf.data(), json.buf.size());
+    }
+    return;
+  }
+  log << "map,scen,N,solved,comp_time_ms,makespan,makespan_lb,sum_of_costs,"
+         "sum_of_costs_lb\n";
+  for (auto& r : runs) {
+    log << r.map_name << "," << r.scen_name << "," << r.N << "," << r.solved
+        << "," << r.comp_time_ms << "," << r.makespan << "," << r.makespan_lb
+        << "," << r.sum_of_costs << "," << r.sum_of_costs_lb << "\n";
+  }
+  log.close();
+}
+
+void Experiment::write_summary(const std::string& filename) const
+{
+  struct Stats {
+    uint num_solved = 0;
+    double comp_time_ms = 0;
+    double makespan_ratio = 0;
+    double sum_of_costs_ratio = 0;
+  };
+  // scenarios per map, and solved runs per (map, N); runs stop at the first
+  // failure, so missing larger N count as failures
+  auto num_scens = std::map<std::string, uint>();
+  for (auto& [map_filename, scen_filename] : tasks) {
+    ++num_scens[fs::path(map_filename).filename().string()];
+  }
+  auto stats = std::map<std::pair<std::string, uint>, Stats>();
+  for (auto& r : runs) {
+    auto& s = stats[{r.map_name, r.N}];
+    if (!r.solved) continue;
+    ++s.num_solved;
+    s.comp_time_ms += r.comp_time_ms;
+    s.makespan_ratio += (double)r.makespan / std::max(r.makespan_lb, 1);
+    s.sum_of_costs_ratio +=
+        (double)r.sum_of_costs / std::max(r.sum_of_costs_lb, 1);
+  }
+
+  std::ofstream log(filename, std::ios::out);
+  log << "map,N,num_scens,success_rate,comp_time_ms,makespan_ratio,"
+         "sum_of_costs_ratio\n";
+  for (auto& [key, s] : stats) {
+    const auto n = num_scens[key.first];
+    const auto d = std::max(s.num_solved, (uint)1);
+    log << key.first << "," << key.second << "," << n << ","
+        << (double)s.num_solved / n << "," << s.comp_time_ms / d << ","
+        << s.makespan_ratio / d << "," << s.sum_of_costs_ratio / d << "\n";
+  }
+  log.close();
+}
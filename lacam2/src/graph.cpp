@@ -1,11 +1,11 @@
 #include "../include/graph.hpp"
 
 Vertex::Vertex(uint _id, uint _index)
-    : id(_id), index(_index), neighbor(Vertices())
+    : id(_id), index(_index), neighbor(Vertices()), in_neighbor(Vertices())
 {
 }
 
-Graph::Graph() : V(Vertices()), width(0), height(0) {}
+Graph::Graph() : V(Vertices()), width(0), height(0), directed(false) {}
 Graph::~Graph()
 {
   for (auto& v : V)
@@ -18,11 +18,12 @@ static const std::regex r_height = std::regex(R"(height\s(\d+))");
 static const std::regex r_width = std::regex(R"(width\s(\d+))");
 static const std::regex r_map = std::regex(R"(map)");
 
-Graph::Graph(const std::string& filename) : V(Vertices()), width(0), height(0)
+Graph::Graph(const std::string& filename)
+    : V(Vertices()), width(0), height(0), directed(false)
 {
   std::ifstream file(filename);
   if (!file) {
-    std::cout << "file " << filename << " is not found." << std::endl;
+    info(0, 0, "file ", filename, " is not found.");
     return;
   }
   std::string line;
@@ -43,6 +44,7 @@ Graph::Graph(const std::string& filename) : V(Vertices()), width(0), height(0)
   }
 
   U = Vertices(width * height, nullptr);
+  auto cells = std::string(width * height, '.');
 
   // create vertices
   uint y = 0;
@@ -56,38 +58,56 @@ Graph::Graph(const std::string& filename) : V(Vertices()), width(0), height(0)
       auto v = new Vertex(V.size(), index);
       V.push_back(v);
       U[index] = v;
+      cells[index] = s;
+      if (s == '>' || s == '<' || s == '^' || s == 'v') directed = true;
     }
     ++y;
   }
   file.close();
 
+  // one-way cells allow a single direction of leaving
+  auto allowed = [&](const uint index, const char dir) {
+    const auto c = cells[index];
+    return (c != '>' && c != '<' && c != '^' && c != 'v') || c == dir;
+  };
+
   // create edges
   for (uint y = 0; y < height; ++y) {
     for (uint x = 0; x < width; ++x) {
       auto v = U[width * y + x];
       if (v == nullptr) continue;
+      const auto k = width * y + x;
       // left
-      if (x > 0) {
+      if (x > 0 && allowed(k, '<')) {
         auto u = U[width * y + (x - 1)];
         if (u != nullptr) v->neighbor.push_back(u);
       }
       // right
-      if (x < width - 1) {
+      if (x < width - 1 && allowed(k, '>')) {
         auto u = U[width * y + (x + 1)];
         if (u != nullptr) v->neighbor.push_back(u);
       }
       // up
-      if (y < height - 1) {
+      if (y < height - 1 && allowed(k, 'v')) {
         auto u = U[width * (y + 1) + x];
         if (u != nullptr) v->neighbor.push_back(u);
       }
       // down
-      if (y > 0) {
+      if (y > 0 && allowed(k, '^')) {
         auto u = U[width * (y - 1) + x];
         if (u != nullptr) v->neighbor.push_back(u);
       }
     }
   }
+
+  // reverse edges, identical to neighbor on undirected maps
+  if (!directed) {
+    for (auto v : V) v->in_neighbor = v->neighbor;
+    return;
+  }
+  for (auto v : V) {
+    for (auto u : v->neighbor) u->in_neighbor.push_back(v);
+  }
 }
 
 uint Graph::size() const { return V.size(); }
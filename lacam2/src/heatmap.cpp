@@ -0,0 +1,79 @@
+#include "../include/heatmap.hpp"
+
+#include "../include/post_processing.hpp"
+
+const char* Heatmap::METRIC_NAMES[] = {"visits", "waits", "conflicts",
+                                       "pushes"};
+
+Heatmap::Heatmap(const Graph& _G) : G(_G)
+{
+  for (auto& vals : values) vals.assign(G.U.size(), 0);
+}
+
+void Heatmap::add_by_id(const Metric metric,
+                        const std::vector<uint64_t>& counts)
+{
+  for (size_t id = 0; id < counts.size() && id < G.V.size(); ++id) {
+    values[metric][G.V[id]->index] += counts[id];
+  }
+}
+
+void Heatmap::add_solution(const Instance& ins, const Solution& solution)
+{
+  if (solution.empty()) return;
+  for (uint i = 0; i < ins.N; ++i) {
+    const auto cost = get_path_cost(solution, i);  // arrival time at goal
+    ++values[VISITS][solution[0][i]->index];
+    for (size_t t = 1; t < solution.size(); ++t) {
+      const auto v = solution[t][i];
+      if (v != solution[t - 1][i]) {
+        ++values[VISITS][v->index];
+      } else if ((int)t < cost) {
+        ++values[WAITS][v->index];
+      }
+    }
+  }
+}
+
+bool Heatmap::write(const std::string& filename) const
+{
+  const auto ext = std::string(".bin");
+  if (filename.size() >= ext.size() &&
+      filename.compare(filename.size() - ext.size(), ext.size(), ext) == 0) {
+    return write_binary(filename);
+  }
+  return write_csv(filename);
+}
+
+bool Heatmap::write_csv(const std::string& filename) const
+{
+  std::ofstream file(filename);
+  if (!file) return false;
+  file << "index,x,y";
+  for (auto name : METRIC_NAMES) file << "," << name;
+  file << "\n";
+  for (size_t k = 0; k < G.U.size(); ++k) {
+    if (G.U[k] == nullptr) continue;
+    file << k << "," << k % G.width << "," << k / G.width;
+    for (auto& vals : values) file << "," << vals[k];
+    file << "\n";
+  }
+  return (bool)file;
+}
+
+bool Heatmap::write_binary(const std::string& filename) const
+{
+  std::ofstream file(filename, std::ios::binary);
+  if (!file) return false;
+  const uint32_t header[] = {G.width, G.height, NUM_METRICS};
+  file.write("LCHM", 4);
+  file.write((const char*)header, sizeof(header));
+  auto buf = std::vector<uint64_t>(G.U.size());
+  for (auto& vals : values) {
+    for (size_t k = 0; k < G.U.size(); ++k) {
+      buf[k] = G.U[k] == nullptr ? UINT64_MAX : vals[k];
+    }
+    file.write((const char*)buf.data(), buf.size() * sizeof(uint64_t));
+  }
+  return (bool)file;
+}
@@ -0,0 +1,83 @@
+#include "../include/huge_pages.hpp"
+
+#include <sys/mman.h>
+
+#include <cstdint>
+#include <new>
+
+std::atomic<size_t> HugePages::bytes_hugetlb(0);
+std::atomic<size_t> HugePages::bytes_thp(0);
+
+// header in front of every region, keeps alignment of the payload
+static constexpr size_t HEADER_SIZE = 64;
+enum AllocMethod { ALLOC_HEAP, ALLOC_HUGETLB, ALLOC_THP };
+
+struct Header {
+  AllocMethod method;
+  size_t mapped;  // #(bytes) of the mapping
+};
+
+static void* set_header(char* base, const AllocMethod method,
+                        const size_t mapped)
+{
+  auto header = (Header*)base;
+  header->method = method;
+  header->mapped = mapped;
+  return base + HEADER_SIZE;
+}
+
+static size_t round_up(const size_t bytes)
+{
+  return (bytes + HugePages::PAGE_SIZE - 1) / HugePages::PAGE_SIZE *
+         HugePages::PAGE_SIZE;
+}
+
+void* HugePages::allocate(const size_t bytes, const bool huge)
+{
+  auto heap = [&]() {
+    return set_header((char*)::operator new(bytes + HEADER_SIZE), ALLOC_HEAP,
+                      0);
+  };
+  // not worth a huge page
+  if (!huge || bytes < PAGE_SIZE / 2) return heap();
+
+  const auto size = round_up(bytes + HEADER_SIZE);
+
+  // explicit huge pages, need reserved pages (vm.nr_hugepages)
+  auto p = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+  if (p != MAP_FAILED) {
+    bytes_hugetlb += size;
+    return set_header((char*)p, ALLOC_HUGETLB, size);
+  }
+
+  // transparent huge pages, the region must be 2MB-aligned
+  p = mmap(nullptr, size + PAGE_SIZE, PROT_READ | PROT_WRITE,
+           MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (p == MAP_FAILED) return heap();
+  const auto addr = (uintptr_t)p;
+  const auto aligned = (addr + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE;
+  if (aligned > addr) munmap(p, aligned - addr);
+  if (aligned < addr + PAGE_SIZE) {
+    munmap((void*)(aligned + size), addr + PAGE_SIZE - aligned);
+  }
+  madvise((void*)aligned, size, MADV_HUGEPAGE);
+  bytes_thp += size;
+  return set_header((char*)aligned, ALLOC_THP, size);
+}
+
+void HugePages::deallocate(void* p, const size_t bytes)
+{
+  if (p == nullptr) return;
+  auto header = (Header*)((char*)p - HEADER_SIZE);
+  if (header->method == ALLOC_HEAP) {
+    ::operator delete(header);
+    return;
+  }
+  if (header->method == ALLOC_HUGETLB) {
+    bytes_hugetlb -= header->mapped;
+  } else {
+    bytes_thp -= header->mapped;
+  }
+  munmap(header, header->mapped);
+}
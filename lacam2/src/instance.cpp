@@ -3,7 +3,8 @@
 Instance::Instance(const std::string& map_filename,
                    const std::vector<uint>& start_indexes,
                    const std::vector<uint>& goal_indexes)
-    : G(map_filename),
+    : graph(std::make_shared<Graph>(map_filename)),
+      G(*graph),
       starts(Config()),
       goals(Config()),
       N(start_indexes.size())
@@ -18,7 +19,11 @@ static const std::regex r_instance =
 
 Instance::Instance(const std::string& scen_filename,
                    const std::string& map_filename, const uint _N)
-    : G(Graph(map_filename)), starts(Config()), goals(Config()), N(_N)
+    : graph(std::make_shared<Graph>(map_filename)),
+      G(*graph),
+      starts(Config()),
+      goals(Config()),
+      N(_N)
 {
   // load start-goal pairs
   std::ifstream file(scen_filename);
@@ -53,7 +58,11 @@ Instance::Instance(const std::string& scen_filename,
 
 Instance::Instance(const std::string& map_filename, std::mt19937* MT,
                    const uint _N)
-    : G(Graph(map_filename)), starts(Config()), goals(Config()), N(_N)
+    : graph(std::make_shared<Graph>(map_filename)),
+      G(*graph),
+      starts(Config()),
+      goals(Config()),
+      N(_N)
 {
   // random assignment
   const auto V_size = G.size();
@@ -83,12 +92,44 @@ Instance::Instance(const std::string& map_filename, std::mt19937* MT,
   }
 }
 
+Instance::Instance(const Instance& base, const uint _N)
+    : graph(base.graph),
+      G(*graph),
+      starts(base.starts.begin(),
+             base.starts.begin() + std::min(_N, (uint)base.starts.size())),
+      goals(base.goals.begin(),
+            base.goals.begin() + std::min(_N, (uint)base.goals.size())),
+      N(_N)
+{
+}
+
 bool Instance::is_valid(const int verbose) const
 {
   if (N != starts.size() || N != goals.size()) {
     info(1, verbose, "invalid N, check instance");
     return false;
   }
+  // one-way cells may disconnect goals
+  if (G.directed) {
+    auto visited = std::vector<uint>(G.size(), 0);
+    for (uint i = 0; i < N; ++i) {
+      auto OPEN = std::queue<Vertex*>({starts[i]});
+      visited[starts[i]->id] = i + 1;
+      while (!OPEN.empty() && visited[goals[i]->id] != i + 1) {
+        auto v = OPEN.front();
+        OPEN.pop();
+        for (auto u : v->neighbor) {
+          if (visited[u->id] == i + 1) continue;
+          visited[u->id] = i + 1;
+          OPEN.push(u);
+        }
+      }
+      if (visited[goals[i]->id] != i + 1) {
+        info(1, verbose, "goal of agent-", i, " is unreachable");
+        return false;
+      }
+    }
+  }
   return true;
 }
 
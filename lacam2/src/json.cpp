@@ -0,0 +1,181 @@
+#include "../include/json.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+
+JsonWriter::JsonWriter() : buf(), is_first(), after_key(false) {}
+
+void JsonWriter::separate()
+{
+  if (after_key) {
+    after_key = false;
+    return;
+  }
+  if (is_first.empty()) return;
+  if (!is_first.back()) buf.push_back(',');
+  is_first.back() = false;
+}
+
+JsonWriter& JsonWriter::begin_object()
+{
+  separate();
+  buf.push_back('{');
+  is_first.push_back(true);
+  return *this;
+}
+
+JsonWriter& JsonWriter::end_object()
+{
+  buf.push_back('}');
+  is_first.pop_back();
+  return *this;
+}
+
+JsonWriter& JsonWriter::begin_array()
+{
+  separate();
+  buf.push_back('[');
+  is_first.push_back(true);
+  return *this;
+}
+
+JsonWriter& JsonWriter::end_array()
+{
+  buf.push_back(']');
+  is_first.pop_back();
+  return *this;
+}
+
+JsonWriter& JsonWriter::key(const std::string& k)
+{
+  value(k);
+  buf.push_back(':');
+  after_key = true;
+  return *this;
+}
+
+JsonWriter& JsonWriter::value(const std::string& v)
+{
+  separate();
+  buf.push_back('"');
+  for (const char c : v) {
+    switch (c) {
+      case '"':
+        buf += "\\\"";
+        break;
+      case '\\':
+        buf += "\\\\";
+        break;
+      case '\n':
+        buf += "\\n";
+        break;
+      case '\t':
+        buf += "\\t";
+        break;
+      case '\r':
+        buf += "\\r";
+        break;
+      default:
+        if ((unsigned char)c < 0x20) {
+          static const char* hex = "0123456789abcdef";
+          buf += "\\u00";
+          buf.push_back(hex[c >> 4]);
+          buf.push_back(hex[c & 0xf]);
+        } else {
+          buf.push_back(c);
+        }
+    }
+  }
+  buf.push_back('"');
+  return *this;
+}
+
+void JsonWriter::append_int(const long long v)
+{
+  separate();
+  char tmp[24];
+  const auto res = std::to_chars(tmp, tmp + sizeof(tmp), v);
+  buf.append(tmp, res.ptr);
+}
+
+void JsonWriter::append_uint(const unsigned long long v)
+{
+  separate();
+  char tmp[24];
+  const auto res = std::to_chars(tmp, tmp + sizeof(tmp), v);
+  buf.append(tmp, res.ptr);
+}
+
+void JsonWriter::append_double(const double v)
+{
+  separate();
+  if (!std::isfinite(v)) {
+    buf += "null";
+    return;
+  }
+  char tmp[32];
+  const auto res = std::to_chars(tmp, tmp + sizeof(tmp), v);
+  buf.append(tmp, res.ptr);
+}
+
+// a JSON number as a whole, -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+// e.g., not "01", "1.", "-.5" nor "inf"
+static bool is_number(const char* first, const char* last)
+{
+  auto p = first;
+  auto is_digit = [&]() { return p != last && *p >= '0' && *p <= '9'; };
+  auto digits = [&]() {
+    if (!is_digit()) return false;
+    while (is_digit()) ++p;
+    return true;
+  };
+  if (p != last && *p == '-') ++p;
+  if (p != last && *p == '0') {
+    ++p;
+  } else if (!digits()) {
+    return false;
+  }
+  if (p != last && *p == '.') {
+    ++p;
+    if (!digits()) return false;
+  }
+  if (p != last && (*p == 'e' || *p == 'E')) {
+    ++p;
+    if (p != last && (*p == '+' || *p == '-')) ++p;
+    if (!digits()) return false;
+  }
+  return p == last;
+}
+
+JsonWriter& JsonWriter::value_of_text(const std::string& text)
+{
+  const auto begin = text.data();
+  const auto end = begin + text.size();
+  if (is_number(begin, end)) {
+    separate();
+    buf += text;
+    return *this;
+  }
+
+  // histograms, e.g., 0,3,5
+  if (text.find(',') != std::string::npos) {
+    auto numeric = true;
+    for (auto p = begin; p <= end && numeric;) {
+      auto q = std::find(p, end, ',');
+      numeric = is_number(p, q);
+      p = q + 1;
+    }
+    if (numeric) {
+      begin_array();
+      for (auto p = begin; p <= end;) {
+        auto q = std::find(p, end, ',');
+        separate();
+        buf.append(p, q);
+        p = q + 1;
+      }
+      return end_array();
+    }
+  }
+  return value(text);
+}
@@ -1,9 +1,72 @@
 #include "../include/lacam2.hpp"
 
+// the keys of Planner::solve, nothing has been searched
+static std::string get_cache_hit_info(const Objective objective,
+                                      const DistMode dist_mode,
+                                      const PlannerOptions& options)
+{
+  auto str = std::string();
+  str += "optimal=0\n";
+  str += "objective=" + std::to_string(objective) + "\n";
+  str += "successor_order=" + std::to_string(options.successor_order) + "\n";
+  str += "num_threads=" +
+         std::to_string(std::max(options.num_threads, (uint)1)) + "\n";
+  if (dist_mode != DIST_BFS) {
+    str += "dist_mode=" + std::to_string(dist_mode) + "\n";
+    str += "dist_table_bytes=0\n";
+    if (dist_mode == DIST_BOUNDED) str += "dist_lower_bounds=0\n";
+  }
+  str += "loop_cnt=0\n";
+  str += "time_setup_ms=0\n";
+  str += "time_first_solution_ms=0\n";
+  str += "time_search_ms=0\n";
+  str += "num_node_gen=0\n";
+  str += "num_node_compacted=0\n";
+  if (!options.cold_dir.empty()) {
+    str += "num_node_spilled=0\n";
+    str += "cold_runs=0\n";
+    str += "cold_merges=0\n";
+    str += "cold_disk_bytes=0\n";
+    str += "cold_block_reads=0\n";
+    str += "cold_bloom_rejects=0\n";
+    str += "cold_failed=0\n";
+  }
+  if (options.perf) str += PerfCounters({}).get_stats();
+  if (options.pibt_stats) str += PIBTStats().str();
+  if (options.huge_pages) {
+    str += "huge_pages_mb=" +
+           std::to_string((HugePages::bytes_hugetlb + HugePages::bytes_thp) >>
+                          20) +
+           "\n";
+  }
+  return str;
+}
+
 Solution solve(const Instance& ins, std::string& additional_info,
                const int verbose, const Deadline* deadline, std::mt19937* MT,
-               const Objective objective, const float restart_rate)
+               const Objective objective, const float restart_rate,
+               SolutionCache* cache, Heatmap* heatmap, DistTable* D,
+               const PlannerOptions& options)
 {
-  auto planner = Planner(&ins, deadline, MT, verbose, objective, restart_rate);
-  return planner.solve(additional_info);
+  // repeated query
+  auto solution = Solution();
+  if (cache != nullptr && cache->find(ins, objective, solution, verbose)) {
+    info(1, verbose, "elapsed:", elapsed_ms(deadline), "ms\tcache hit");
+    additional_info += get_cache_hit_info(
+        objective, D != nullptr ? D->mode : options.dist.mode, options);
+    additional_info += "cache_hit=1\n";
+    if (heatmap != nullptr) heatmap->add_solution(ins, solution);
+    return solution;
+  }
+
+  auto planner = Planner(&ins, deadline, MT, verbose, objective, restart_rate,
+                         D, options);
+  planner.heatmap = heatmap;
+  solution = planner.solve(additional_info);
+  if (heatmap != nullptr) heatmap->add_solution(ins, solution);
+  if (cache != nullptr) {
+    additional_info += "cache_hit=0\n";
+    cache->insert(ins, objective, solution);
+  }
+  return solution;
 }
@@ -0,0 +1,139 @@
+#include "../include/landmarks.hpp"
+
+// BFS from s, over reverse edges when reverse; d[v * stride]
+static void bfs(Vertex* s, const bool reverse, const uint V_size, uint* d,
+                const size_t stride, const uint max_dist = UINT_MAX)
+{
+  for (size_t k = 0; k < V_size; ++k) d[k * stride] = V_size;
+  auto OPEN = std::queue<Vertex*>({s});
+  d[s->id * stride] = 0;
+  while (!OPEN.empty()) {
+    auto n = OPEN.front();
+    OPEN.pop();
+    const auto d_n = d[n->id * stride];
+    if (d_n >= max_dist) continue;
+    for (auto m : reverse ? n->in_neighbor : n->neighbor) {
+      if (d[m->id * stride] <= d_n + 1) continue;
+      d[m->id * stride] = d_n + 1;
+      OPEN.push(m);
+    }
+  }
+}
+
+Landmarks::Landmarks() : V_size(0), K(0), radius(0) {}
+
+void Landmarks::setup(const Instance* ins, const uint _K,
+                      const LandmarkSelection selection, const uint _radius)
+{
+  const auto& G = ins->G;
+  V_size = G.size();
+  K = std::max(std::min(_K, V_size), (uint)1);
+  radius = _radius;
+  dist_from.assign((size_t)V_size * K, V_size);
+  if (G.directed) dist_to.assign((size_t)V_size * K, V_size);
+
+  // select landmarks, deterministic
+  auto MT = std::mt19937(0);
+  auto tmp = std::vector<uint>(V_size);
+  auto min_dist = std::vector<uint>(V_size, V_size);  // to chosen landmarks
+  auto chosen = std::vector<bool>(V_size, false);
+  auto next = G.V[get_random_int(&MT, 0, V_size - 1)];
+  if (selection == LANDMARK_FARTHEST) {
+    // start from the farthest vertex of a random one
+    bfs(next, false, V_size, tmp.data(), 1);
+    for (auto v : G.V) {
+      if (tmp[v->id] < V_size && tmp[v->id] > tmp[next->id]) next = v;
+    }
+  }
+  // landmarks are distinct, K <= V_size
+  for (uint l = 0; l < K; ++l) {
+    vertices.push_back(next);
+    chosen[next->id] = true;
+    bfs(next, false, V_size, &dist_from[l], K);
+    if (G.directed) bfs(next, true, V_size, &dist_to[l], K);
+    if (l + 1 == K) break;
+    if (selection == LANDMARK_RANDOM) {
+      do {
+        next = G.V[get_random_int(&MT, 0, V_size - 1)];
+      } while (chosen[next->id]);
+      continue;
+    }
+    // maximize the distance to the nearest landmark, all distances first
+    for (auto v : G.V) {
+      min_dist[v->id] = std::min(min_dist[v->id], dist_from[v->id * K + l]);
+    }
+    next = nullptr;
+    for (auto v : G.V) {
+      if (chosen[v->id] || min_dist[v->id] == V_size) continue;
+      if (next == nullptr || min_dist[v->id] > min_dist[next->id]) next = v;
+    }
+    // the reachable part is covered, continue elsewhere
+    if (next == nullptr) {
+      for (auto v : G.V) {
+        if (chosen[v->id]) continue;
+        next = v;
+        break;
+      }
+    }
+  }
+
+  // per agent
+  const auto& dist_to_ref = G.directed ? dist_to : dist_from;
+  goal_from.resize((size_t)ins->N * K);
+  goal_to.resize((size_t)ins->N * K);
+  balls.resize(ins->N);
+  for (uint i = 0; i < ins->N; ++i) {
+    const auto g = ins->goals[i];
+    for (uint l = 0; l < K; ++l) {
+      goal_from[i * K + l] = dist_from[g->id * K + l];
+      goal_to[i * K + l] = dist_to_ref[g->id * K + l];
+    }
+    // exact distances to the goal nearby, over reverse edges
+    bfs(g, true, V_size, tmp.data(), 1, radius);
+    for (uint v = 0; v < V_size; ++v) {
+      if (tmp[v] <= radius) balls[i].emplace_back(v, tmp[v]);
+    }
+  }
+}
+
+uint Landmarks::get(const uint i, const uint v_id) const
+{
+  // exact
+  const auto& ball = balls[i];
+  auto itr = std::lower_bound(ball.begin(), ball.end(),
+                              std::make_pair(v_id, (uint)0));
+  if (itr != ball.end() && itr->first == v_id) return itr->second;
+
+  // lower bound, outside of the ball
+  auto h = radius + 1;
+  const auto from_v = &dist_from[(size_t)v_id * K];
+  const auto to_v = dist_to.empty() ? from_v : &dist_to[(size_t)v_id * K];
+  const auto from_g = &goal_from[(size_t)i * K];
+  const auto to_g = &goal_to[(size_t)i * K];
+  for (uint l = 0; l < K; ++l) {
+    if (from_g[l] < V_size && from_v[l] < V_size && from_g[l] > from_v[l])
+      h = std::max(h, from_g[l] - from_v[l]);
+    if (to_v[l] < V_size && to_g[l] < V_size && to_v[l] > to_g[l])
+      h = std::max(h, to_v[l] - to_g[l]);
+  }
+  return h;
+}
+
+size_t Landmarks::memory_usage() const
+{
+  size_t bytes = (dist_from.size() + dist_to.size() + goal_from.size() +
+                  goal_to.size()) *
+                 sizeof(uint);
+  for (auto& ball : balls) bytes += ball.size() * sizeof(ball[0]);
+  return bytes;
+}
+
+std::ostream& operator<<(std::ostream& os, const LandmarkSelection selection)
+{
+  if (selection == LANDMARK_RANDOM) {
+    os << "random";
+  } else if (selection == LANDMARK_FARTHEST) {
+    os << "farthest";
+  }
+  return os;
+}
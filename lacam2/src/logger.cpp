@@ -0,0 +1,278 @@
+#include "../include/logger.hpp"
+
+#include <pthread.h>
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+// std::string as the target of a std::ostream
+struct LineBuf : public std::streambuf {
+  std::string line;
+
+  int_type overflow(int_type c) override
+  {
+    if (c != traits_type::eof()) line.push_back(traits_type::to_char_type(c));
+    return c;
+  }
+  std::streamsize xsputn(const char* s, std::streamsize n) override
+  {
+    line.append(s, n);
+    return n;
+  }
+};
+
+struct LineStream {
+  LineBuf buf;
+  std::ostream os;
+  LineStream() : buf(), os(&buf) {}
+};
+
+LineStream& get_line_stream()
+{
+  thread_local LineStream stream;
+  return stream;
+}
+
+// c.f., Vyukov's bounded MPMC queue, with a single consumer
+struct Slot {
+  std::atomic<size_t> seq;
+  std::string line;
+};
+
+struct State {
+  std::mutex mtx;  // sinks, and the writes in the synchronous mode
+  std::vector<Logger::Sink> sinks;
+
+  std::vector<Slot> slots;
+  alignas(64) std::atomic<size_t> enqueue_pos;
+  alignas(64) size_t dequeue_pos;     // writer only
+  std::atomic<size_t> num_written;    // lines passed to the sinks
+  std::atomic<bool> async;
+  std::atomic<bool> running;
+  std::thread* writer;  // leaked in forked children
+
+  State()
+      : mtx(),
+        sinks(),
+        slots(Logger::CAPACITY),
+        enqueue_pos(0),
+        dequeue_pos(0),
+        num_written(0),
+        async(false),
+        running(false),
+        writer(nullptr)
+  {
+    reset_queue();
+    add_stdout();
+    pthread_atfork([]() { get().mtx.lock(); }, []() { get().mtx.unlock(); },
+                   []() {
+                     auto& s = get();
+                     s.mtx.unlock();
+                     s.writer = nullptr;  // not running in the child
+                     s.async = false;
+                     s.running = false;
+                     s.reset_queue();
+                   });
+  }
+  ~State() { stop(); }
+
+  static State& get()
+  {
+    static State state;
+    return state;
+  }
+
+  void reset_queue()
+  {
+    for (size_t k = 0; k < slots.size(); ++k) {
+      slots[k].seq.store(k, std::memory_order_relaxed);
+      slots[k].line.clear();
+    }
+    enqueue_pos = 0;
+    dequeue_pos = 0;
+    num_written = 0;
+  }
+
+  void add_stdout()
+  {
+    sinks.push_back([](const std::string& lines) {
+      std::cout.write(lines.data(), lines.size());
+      std::cout.flush();
+    });
+  }
+
+  void write(const std::string& lines)
+  {
+    auto lock = std::lock_guard<std::mutex>(mtx);
+    for (auto& sink : sinks) sink(lines);
+  }
+
+  // swaps line into the queue, receiving an empty buffer
+  void push(std::string& line)
+  {
+    const auto mask = slots.size() - 1;
+    auto pos = enqueue_pos.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+      slot = &slots[pos & mask];
+      const auto seq = slot->seq.load(std::memory_order_acquire);
+      const auto diff = (intptr_t)seq - (intptr_t)pos;
+      if (diff == 0) {
+        if (enqueue_pos.compare_exchange_weak(pos, pos + 1,
+                                              std::memory_order_relaxed)) {
+          break;
+        }
+      } else {
+        if (diff < 0) std::this_thread::yield();  // full, wait for the writer
+        pos = enqueue_pos.load(std::memory_order_relaxed);
+      }
+    }
+    slot->line.swap(line);
+    slot->seq.store(pos + 1, std::memory_order_release);
+  }
+
+  bool pop(std::string& batch)
+  {
+    auto& slot = slots[dequeue_pos & (slots.size() - 1)];
+    if (slot.seq.load(std::memory_order_acquire) != dequeue_pos + 1) {
+      return false;
+    }
+    batch += slot.line;
+    slot.line.clear();
+    slot.seq.store(dequeue_pos + slots.size(), std::memory_order_release);
+    ++dequeue_pos;
+    return true;
+  }
+
+  // writes everything in the queue; false if empty
+  bool drain(std::string& batch)
+  {
+    batch.clear();
+    while (batch.size() < (1 << 16) && pop(batch)) {
+    }
+    if (batch.empty()) return false;
+    write(batch);
+    num_written.store(dequeue_pos, std::memory_order_release);
+    return true;
+  }
+
+  void start()
+  {
+    if (writer != nullptr) return;
+    running = true;
+    async = true;
+    writer = new std::thread([this]() { work(); });
+  }
+
+  void stop()
+  {
+    if (writer == nullptr) return;
+    async = false;
+    running = false;
+    writer->join();
+    delete writer;
+    writer = nullptr;
+    // lines pushed while stopping
+    auto batch = std::string();
+    while (drain(batch)) {
+    }
+  }
+
+  void work()
+  {
+    auto batch = std::string();
+    uint idle = 0;
+    while (true) {
+      if (drain(batch)) {
+        idle = 0;
+        continue;
+      }
+      if (!running.load(std::memory_order_acquire)) break;
+      // back off while idle, producers do not notify
+      if (++idle < 64) {
+        std::this_thread::yield();
+      } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+      }
+    }
+  }
+};
+
+}  // namespace
+
+std::ostream& Logger::begin()
+{
+  auto& stream = get_line_stream();
+  stream.buf.line.clear();
+  return stream.os;
+}
+
+void Logger::end()
+{
+  auto& line = get_line_stream().buf.line;
+  line.push_back('\n');
+  auto& state = State::get();
+  if (state.async.load(std::memory_order_acquire)) {
+    state.push(line);
+  } else {
+    state.write(line);
+  }
+}
+
+void Logger::start() { State::get().start(); }
+
+void Logger::stop() { State::get().stop(); }
+
+bool Logger::is_async() { return State::get().async; }
+
+void Logger::flush()
+{
+  auto& state = State::get();
+  if (!state.async) return;
+  const auto target = state.enqueue_pos.load(std::memory_order_acquire);
+  while (state.running &&
+         state.num_written.load(std::memory_order_acquire) < target) {
+    std::this_thread::yield();
+  }
+}
+
+void Logger::add_sink(const Sink& sink)
+{
+  auto& state = State::get();
+  auto lock = std::lock_guard<std::mutex>(state.mtx);
+  state.sinks.push_back(sink);
+}
+
+bool Logger::add_file_sink(const std::string& filename)
+{
+  auto file = std::make_shared<std::ofstream>(filename, std::ios::app);
+  if (!*file) return false;
+  add_sink([file](const std::string& lines) {
+    file->write(lines.data(), lines.size());
+    file->flush();
+  });
+  return true;
+}
+
+void Logger::add_stdout_sink()
+{
+  auto& state = State::get();
+  auto lock = std::lock_guard<std::mutex>(state.mtx);
+  state.add_stdout();
+}
+
+void Logger::clear_sinks()
+{
+  auto& state = State::get();
+  auto lock = std::lock_guard<std::mutex>(state.mtx);
+  state.sinks.clear();
+}
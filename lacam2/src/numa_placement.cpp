@@ -0,0 +1,130 @@
+#include "../include/numa_placement.hpp"
+
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstdint>
+
+#ifdef LACAM_HAS_NUMA
+#include <numa.h>
+#include <numaif.h>
+#endif
+
+#ifndef LACAM_HAS_NUMA
+// e.g., "0-3,8-11"
+static std::vector<int> parse_cpulist(const std::string& str)
+{
+  auto cpus = std::vector<int>();
+  std::stringstream ss(str);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    if (item.empty()) continue;
+    const auto pos = item.find('-');
+    const auto from = std::stoi(item.substr(0, pos));
+    const auto to = pos == std::string::npos ? from : std::stoi(item.substr(pos + 1));
+    for (auto c = from; c <= to; ++c) cpus.push_back(c);
+  }
+  return cpus;
+}
+
+static std::vector<int> get_node_cpus(const int node)
+{
+  std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) +
+                     "/cpulist");
+  std::string line;
+  if (!file || !std::getline(file, line)) return std::vector<int>();
+  return parse_cpulist(line);
+}
+#endif
+
+int Numa::num_nodes()
+{
+  static const int cnt = []() {
+#ifdef LACAM_HAS_NUMA
+    if (numa_available() < 0) return 1;
+    return std::max(numa_num_configured_nodes(), 1);
+#else
+    auto k = 0;
+    while (!get_node_cpus(k).empty()) ++k;
+    return std::max(k, 1);
+#endif
+  }();
+  return cnt;
+}
+
+int Numa::node_of_worker(const size_t worker_id)
+{
+  return worker_id % num_nodes();
+}
+
+bool Numa::pin_thread(const int node)
+{
+#ifdef LACAM_HAS_NUMA
+  if (numa_available() < 0) return false;
+  return numa_run_on_node(node) == 0;
+#else
+  const auto cpus = get_node_cpus(node);
+  if (cpus.empty()) return false;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (auto c : cpus) CPU_SET(c, &set);
+  return sched_setaffinity(0, sizeof(set), &set) == 0;
+#endif
+}
+
+// affinity of the caller before pin_pool
+static thread_local cpu_set_t caller_affinity;
+static thread_local bool caller_pinned = false;
+
+void Numa::pin_pool(ThreadPool* pool)
+{
+  if (!caller_pinned) {
+    caller_pinned =
+        sched_getaffinity(0, sizeof(caller_affinity), &caller_affinity) == 0;
+  }
+  if (pool == nullptr) {
+    pin_thread(0);
+    return;
+  }
+  pool->run_each([&](size_t k) { pin_thread(node_of_worker(k)); });
+}
+
+void Numa::unpin_caller()
+{
+  if (!caller_pinned) return;
+  sched_setaffinity(0, sizeof(caller_affinity), &caller_affinity);
+  caller_pinned = false;
+}
+
+void Numa::place(void* p, const size_t bytes, const int node)
+{
+  const auto page = (uintptr_t)sysconf(_SC_PAGESIZE);
+  const auto from = ((uintptr_t)p + page - 1) / page * page;
+  const auto to = ((uintptr_t)p + bytes) / page * page;
+  if (from >= to) return;
+#ifdef LACAM_HAS_NUMA
+  if (numa_available() >= 0) {
+    unsigned long mask = 1UL << node;
+    // preferred, not bound; falls back to other nodes when it is full
+    mbind((void*)from, to - from, MPOL_PREFERRED, &mask, sizeof(mask) * 8,
+          MPOL_MF_MOVE);
+    return;
+  }
+#endif
+  // pages are refaulted by the next touch, on the node of the toucher
+  madvise((void*)from, to - from, MADV_DONTNEED);
+}
+
+int Numa::node_of_address(const void* p)
+{
+#ifdef LACAM_HAS_NUMA
+  if (numa_available() < 0) return -1;
+  int node = -1;
+  if (get_mempolicy(&node, nullptr, 0, (void*)p, MPOL_F_NODE | MPOL_F_ADDR) != 0)
+    return -1;
+  return node;
+#else
+  return -1;
+#endif
+}
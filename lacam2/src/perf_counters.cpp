@@ -0,0 +1,118 @@
+#include "../include/perf_counters.hpp"
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+static const char* EVENT_NAMES[] = {"cycles", "instructions", "llc_misses",
+                                    "branch_misses"};
+
+static int open_event(const uint64_t config, const int group_fd)
+{
+  perf_event_attr attr{};
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = config;
+  attr.disabled = group_fd < 0;  // the leader enables the group
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                     PERF_FORMAT_TOTAL_TIME_RUNNING;
+  return syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
+
+PerfCounters::PerfCounters(const std::vector<std::string>& _phase_names,
+                           const bool enabled)
+    : group_fd(-1),
+      available(false),
+      phase_names(_phase_names),
+      totals(_phase_names.size(), Values{}),
+      num_calls(_phase_names.size(), 0),
+      last(),
+      last_enabled(0),
+      last_running(0),
+      time_enabled(0),
+      time_running(0)
+{
+  fds.fill(-1);
+  if (!enabled) return;
+  const uint64_t configs[NUM_EVENTS] = {
+      PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+      PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+  for (size_t e = 0; e < NUM_EVENTS; ++e) {
+    fds[e] = open_event(configs[e], group_fd);
+    if (fds[e] < 0) return;  // unavailable, no-op from here
+    if (e == 0) group_fd = fds[e];
+  }
+  available = true;
+  ioctl(group_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(group_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+PerfCounters::~PerfCounters()
+{
+  for (auto fd : fds) {
+    if (fd >= 0) close(fd);
+  }
+}
+
+bool PerfCounters::read(Values& values, uint64_t& enabled,
+                        uint64_t& running) const
+{
+  // format: nr, time_enabled, time_running, values...
+  uint64_t buf[3 + NUM_EVENTS];
+  if (::read(group_fd, buf, sizeof(buf)) != sizeof(buf)) return false;
+  enabled = buf[1];
+  running = buf[2];
+  for (size_t e = 0; e < NUM_EVENTS; ++e) values[e] = buf[3 + e];
+  return true;
+}
+
+void PerfCounters::start()
+{
+  if (!available) return;
+  read(last, last_enabled, last_running);
+}
+
+void PerfCounters::stop(const uint phase)
+{
+  if (!available) return;
+  Values now;
+  uint64_t enabled, running;
+  if (!read(now, enabled, running)) return;
+  // the group is scheduled as a whole, one ratio for all events
+  const auto d_enabled = enabled - last_enabled;
+  const auto d_running = running - last_running;
+  time_enabled += d_enabled;
+  time_running += d_running;
+  ++num_calls[phase];
+  if (d_running == 0) return;  // not scheduled during the phase
+  const auto scale = (double)d_enabled / d_running;
+  for (size_t e = 0; e < NUM_EVENTS; ++e) {
+    totals[phase][e] += (uint64_t)((now[e] - last[e]) * scale + 0.5);
+  }
+}
+
+std::string PerfCounters::get_stats() const
+{
+  auto str = std::string("perf_available=") + std::to_string(available) + "\n";
+  if (!available) return str;
+  // 1: counters were multiplexed, values are estimates
+  str += "perf_multiplexed=" + std::to_string(time_running < time_enabled) +
+         "\n";
+  str += "perf_running_ratio=" +
+         std::to_string(time_enabled == 0
+                            ? 1.0
+                            : (double)time_running / time_enabled) +
+         "\n";
+  for (size_t p = 0; p < phase_names.size(); ++p) {
+    const auto prefix = "perf_" + phase_names[p] + "_";
+    str += prefix + "calls=" + std::to_string(num_calls[p]) + "\n";
+    for (size_t e = 0; e < NUM_EVENTS; ++e) {
+      str += prefix + EVENT_NAMES[e] + "=" + std::to_string(totals[p][e]) +
+             "\n";
+    }
+  }
+  return str;
+}
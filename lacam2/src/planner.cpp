@@ -11,7 +11,7 @@ LNode::LNode(LNode* _parent, uint i, Vertex* v)
 //  }
 }
 
-uint HNode::HNODE_CNT = 0;
+std::atomic<uint> HNode::HNODE_CNT = 0;
 
 // for high-level, 构造函数，生成节点时从父亲继承、更新每个agent的优先级
 HNode::HNode(const Config& _C, DistTable& D, HNode* _parent, const uint _g,
@@ -22,20 +22,30 @@ HNode::HNode(const Config& _C, DistTable& D, HNode* _parent, const uint _g,
       g(_g),
       h(_h),
       f(g + h),
-      priorities(C.size()),
-      order(C.size(), 0),
-      search_tree(std::queue<LNode*>())
+      priorities(),
+      order(),
+      search_tree(std::queue<LNode*>()),
+      lnodes(),
+      pending()
 {
   ++HNODE_CNT;
 
-  search_tree.push(new LNode());
-  const auto N = C.size();
+  // update neighbor, g is given as parent->g + edge cost
+  if (parent != nullptr) parent->neighbor.emplace(this, g - parent->g);
+
+  setup_lowlevel(D);
+}
 
-  // update neighbor
-  if (parent != nullptr) parent->neighbor.insert(this);
+void HNode::setup_lowlevel(DistTable& D)
+{
+  const auto N = C.size();
+  priorities.resize(N);
+  order.resize(N);
+  lnodes.push_back(new LNode());
+  search_tree.push(lnodes.back());
 
   // set priorities
-  if (parent == nullptr) {
+  if (parent == nullptr || parent->is_compacted()) {
     // initialize
     for (uint i = 0; i < N; ++i) priorities[i] = (float)D.get(i, C[i]) / N;
   } else {
@@ -55,65 +65,184 @@ HNode::HNode(const Config& _C, DistTable& D, HNode* _parent, const uint _g,
             [&](uint i, uint j) { return priorities[i] > priorities[j]; });
 }
 
+void HNode::compact()
+{
+  for (auto L : lnodes) delete L;
+  std::vector<LNode*>().swap(lnodes);
+  std::queue<LNode*>().swap(search_tree);
+  std::vector<float>().swap(priorities);
+  std::vector<uint>().swap(order);
+  std::vector<std::pair<HNode*, bool> >().swap(pending);
+}
+
+bool HNode::is_compacted() const { return order.empty(); }
+
 HNode::~HNode()
 {
-  while (!search_tree.empty()) {
-    delete search_tree.front();
-    search_tree.pop();
-  }
+  for (auto L : lnodes) delete L;
 }
 
 Planner::Planner(const Instance* _ins, const Deadline* _deadline,
                  std::mt19937* _MT, const int _verbose,
-                 const Objective _objective, const float _restart_rate)
+                 const Objective _objective, const float _restart_rate,
+                 DistTable* _D, const PlannerOptions& _options)
     : ins(_ins),
       deadline(_deadline),
       MT(_MT),
       verbose(_verbose),
       objective(_objective),
       RESTART_RATE(_restart_rate),
+      options(_options),
       N(ins->N),
       V_size(ins->G.size()),
-      D(DistTable(ins)),
+      D_owned(_D == nullptr ? new DistTable(ins, options.dist) : nullptr),
+      D(_D == nullptr ? *D_owned : *_D),
       loop_cnt(0),
-      C_next(N),
-      tie_breakers(V_size, 0),
-      A(N, nullptr),
-      occupied_now(V_size, nullptr),
-      occupied_next(V_size, nullptr)
+      num_node_compacted(0),
+      MTs(),
+      workers(),
+      pool(nullptr),
+      cold(nullptr),
+      hot_nodes(),
+      perf({"setup", "lowlevel", "pibt", "explored", "register"},
+           options.perf),
+      heatmap(nullptr)
 {
+  if (D_owned == nullptr) D.extend(ins);
+  const auto num_workers = std::max(options.num_threads, (uint)1);
+  workers.push_back(new PIBT(ins, D, MT, options));
+  if (num_workers > 1) {
+    pool = new ThreadPool(num_workers);
+    perf.start();
+    D.setup_all(pool);  // lazy evaluation is not thread-safe
+    perf.stop(PHASE_SETUP);
+    MTs.reserve(num_workers);
+    for (uint k = 1; k < num_workers; ++k) {
+      MTs.emplace_back(MT == nullptr ? k : (*MT)());
+    }
+    // allocated by the own thread, node-local with first-touch
+    workers.resize(num_workers, nullptr);
+    auto create = [&](size_t k) {
+      if (k == 0) return;
+      workers[k] =
+          new PIBT(ins, D, MT == nullptr ? nullptr : &MTs[k - 1], options);
+    };
+    if (options.numa) {
+      pool->run_each(create);
+    } else {
+      for (uint k = 1; k < num_workers; ++k) create(k);
+    }
+  }
 }
 
-Planner::~Planner() {}
+Planner::~Planner()
+{
+  for (auto w : workers) delete w;
+  if (pool != nullptr) delete pool;
+  if (D_owned != nullptr) delete D_owned;
+  if (cold != nullptr) delete cold;
+}
 
 Solution Planner::solve(std::string& additional_info)
 {
   solver_info(1, "start search");
-
-  // setup agents
-  for (auto i = 0; i < N; ++i) A[i] = new Agent(i);
+  // timing breakdown, since the deadline started
+  const auto time_setup_ms = elapsed_ns(deadline) / 1e6;
+  auto time_first_solution_ms = 0.0;
 
   // setup search
+  if (heatmap != nullptr) {
+    for (auto w : workers) {
+      w->vertex_conflicts.assign(V_size, 0);
+      w->vertex_pushes.assign(V_size, 0);
+    }
+  }
+  if (!options.cold_dir.empty() && cold == nullptr)
+    cold = new ColdStore(options.cold_dir, ins->G.V, N);
   auto OPEN = std::stack<HNode*>();
-  auto EXPLORED = std::unordered_map<Config, HNode*, ConfigHasher>();
+  auto EXPLORED = Explored<HNode>(1024, options.huge_pages);
   // insert initial node, 'H': high-level node
   auto H_init = new HNode(ins->starts, D, nullptr, 0, get_h_value(ins->starts));
   OPEN.push(H_init);
-  EXPLORED[H_init->C] = H_init;
+  EXPLORED.insert(H_init);
+  auto spilling = (cold != nullptr);  // off after a write failure
+  auto cold_failed = false;           // search stops after a read failure
+  if (spilling) hot_nodes.push_back(H_init);
 
   std::vector<Config> solution;
   auto C_new = Config(N, nullptr);  // for new configuration
   HNode* H_goal = nullptr;          // to store goal node
 
+  // for batched parallel expansion
+  std::vector<LNode*> batch;
+  std::vector<int> batch_res(workers.size(), 0);
+  std::vector<Config> batch_C(workers.size(), Config(N, nullptr));
+  std::vector<const Config*> batch_keys;
+  std::vector<uint> batch_hashes;
+  std::vector<HNode*> batch_found;
+
+  // register a successor of H, H_found: lookup result in EXPLORED
+  auto register_config = [&](HNode* H, const Config& C_new, const uint hash,
+                             HNode* H_found) {
+    if (H_found != nullptr) { // C_new出现过，更新
+      // case found
+      rewrite(H, H_found, get_edge_cost(H->C, C_new), H_goal,OPEN); // dijkstra
+      return H_found;
+    }
+    // insert new search node
+    const auto H_new = new HNode(
+        C_new, D, H, H->g + get_edge_cost(H->C, C_new), get_h_value(C_new));
+    EXPLORED.insert(H_new, hash);
+    if (spilling) hot_nodes.push_back(H_new);
+    return H_new;
+  };
+
+  // continue the search from a successor
+  auto push_successor = [&](HNode* H_next, const bool explored) {
+    if (explored) {
+      // re-insert or random-restart
+      auto H_insert = (MT != nullptr && get_random_float(MT) >= RESTART_RATE)
+                          ? H_next
+                          : H_init;
+      if (H_goal == nullptr || H_insert->f < H_goal->f) OPEN.push(H_insert);
+    } else if (H_goal == nullptr || H_next->f < H_goal->f) {
+      OPEN.push(H_next);
+    }
+  };
+
   // DFS
   while (!OPEN.empty() && !is_expired(deadline)) {
     loop_cnt += 1;
 
+    // move old configurations to disk
+    if (spilling && EXPLORED.num_entries > options.hot_capacity) {
+      spilling = spill(EXPLORED);
+    }
+
     // do not pop here!
     auto H = OPEN.top();  // high-level node
 
+    // compacted nodes are dominated, unless g-value has been updated
+    if (H->is_compacted()) {
+      if (H_goal != nullptr && H->f >= H_goal->f) {
+        OPEN.pop();
+        continue;
+      }
+      if (H->C.empty() && !load(EXPLORED, H)) {
+        cold_failed = true;
+        break;
+      }
+      H->setup_lowlevel(D);
+    }
+
+    // free dominated nodes during refinement
+    if (H_goal != nullptr && options.gc_interval > 0 &&
+        loop_cnt % options.gc_interval == 0) {
+      compact(EXPLORED, H_goal);
+    }
+
     // low-level search end
-    if (H->search_tree.empty()) {
+    if (H->search_tree.empty() && H->pending.empty()) {
       OPEN.pop();
       continue;
     }
@@ -127,57 +256,123 @@ Solution Planner::solve(std::string& additional_info)
     // check goal condition 所有agent到达终点
     if (H_goal == nullptr && is_same_config(H->C, ins->goals)) {
       H_goal = H;
+      time_first_solution_ms = elapsed_ns(deadline) / 1e6;
       solver_info(1, "found solution, cost: ", H->g);
-      //if (objective == OBJ_NONE) break;
-//      continue;
-      break;
+      if (objective == OBJ_NONE || !options.refine) break;
+      continue;
+    }
+
+    if (workers.size() > 1) {
+      if (H->pending.empty()) {
+        // generate successors in parallel, consumed in the popped order
+        batch.clear();
+        perf.start();
+        while (batch.size() < workers.size() && !H->search_tree.empty()) {
+          auto L = H->search_tree.front();
+          H->search_tree.pop();
+          expand_lowlevel_tree(H, L);
+          batch.push_back(L);
+        }
+        perf.stop(PHASE_LOWLEVEL);
+        perf.start();
+        auto generate = [&](size_t k) {
+          batch_res[k] = workers[k]->get_new_config(H, batch[k]);
+          if (!batch_res[k]) return;
+          for (auto a : workers[k]->A) batch_C[k][a->id] = a->v_next;
+        };
+        // workers[k] was allocated by thread k
+        if (options.numa) {
+          pool->run_bound(batch.size(), generate);
+        } else {
+          pool->run(batch.size(), generate);
+        }
+        perf.stop(PHASE_PIBT);
+
+        // check explored list at once
+        batch_keys.clear();
+        for (size_t k = 0; k < batch.size(); ++k) {
+          if (batch_res[k]) batch_keys.push_back(&batch_C[k]);
+        }
+        perf.start();
+        EXPLORED.find_batch(batch_keys, batch_hashes, batch_found);
+        perf.stop(PHASE_EXPLORED);
+        perf.start();
+        auto inserted = false;
+        for (size_t k = 0; k < batch_keys.size(); ++k) {
+          auto H_found = batch_found[k];
+          // lookup results are outdated after insertions
+          if (H_found == nullptr && inserted)
+            H_found = EXPLORED.find(*batch_keys[k], batch_hashes[k]);
+          if (H_found == nullptr) H_found = find_cold(*batch_keys[k]);
+          auto H_next =
+              register_config(H, *batch_keys[k], batch_hashes[k], H_found);
+          inserted |= H_found == nullptr;
+          H->pending.emplace_back(H_next, H_found != nullptr);
+        }
+        perf.stop(PHASE_REGISTER);
+        std::reverse(H->pending.begin(), H->pending.end());
+        if (H->pending.empty()) continue;
+      }
+      const auto [H_next, explored] = H->pending.back();
+      H->pending.pop_back();
+      push_successor(H_next, explored);
+      continue;
     }
 
     // create successors at the low-level search, BFS
     auto L = H->search_tree.front();
     H->search_tree.pop();
+    perf.start();
     expand_lowlevel_tree(H, L);
+    perf.stop(PHASE_LOWLEVEL);
 
     // create successors at the high-level search
-    const auto res = get_new_config(H, L);
+    perf.start();
+    const auto res = workers[0]->get_new_config(H, L);
+    perf.stop(PHASE_PIBT);
     //delete L;  // free
     if (!res) continue;
 
     // create new configuration
-    for (auto a : A) C_new[a->id] = a->v_next;
+    for (auto a : workers[0]->A) C_new[a->id] = a->v_next;
 
     // check explored list
-    const auto iter = EXPLORED.find(C_new);
-    if (iter != EXPLORED.end()) { // C_new出现过，更新
-      // case found
-      rewrite(H, iter->second, H_goal,OPEN); // dijkstra
-      // re-insert or random-restart
-
-      auto H_insert = (MT != nullptr && get_random_float(MT) >= RESTART_RATE)
-                          ? iter->second
-                          : H_init;
-      if (H_goal == nullptr || H_insert->f < H_goal->f) OPEN.push(H_insert);
-    } else {
-      // insert new search node
-      const auto H_new = new HNode(
-          C_new, D, H, H->g + get_edge_cost(H->C, C_new), get_h_value(C_new));
-      EXPLORED[H_new->C] = H_new;
-      if (H_goal == nullptr || H_new->f < H_goal->f) OPEN.push(H_new);
-    }
+    perf.start();
+    const auto hash = EXPLORED.get_hash(C_new);
+    auto H_found = EXPLORED.find(C_new, hash);
+    if (H_found == nullptr) H_found = find_cold(C_new);
+    perf.stop(PHASE_EXPLORED);
+    perf.start();
+    const auto H_next = register_config(H, C_new, hash, H_found);
+    perf.stop(PHASE_REGISTER);
+    push_successor(H_next, H_found != nullptr);
   }
+  const auto time_search_ms = elapsed_ns(deadline) / 1e6 - time_setup_ms;
 
   // backtrack
   if (H_goal != nullptr) {
     auto H = H_goal;
+    auto C = Config();
     while (H != nullptr) {
-      solution.push_back(H->C);
+      if (H->C.empty() && !cold->read((uint64_t)H, C)) {
+        // never emit a partial solution
+        solver_info(1, "failed to read a configuration from ",
+                    options.cold_dir);
+        cold_failed = true;
+        solution.clear();
+        H_goal = nullptr;
+        break;
+      }
+      solution.push_back(H->C.empty() ? C : H->C);
       H = H->parent;
     }
     std::reverse(solution.begin(), solution.end());
   }
 
   // print result
-  if (H_goal != nullptr && OPEN.empty()) {
+  if (cold_failed) {
+    solver_info(1, "stopped, cold store is unreadable");
+  } else if (H_goal != nullptr && OPEN.empty()) {
     solver_info(1, "solved optimally, objective: ", objective);
   } else if (H_goal != nullptr) {
     solver_info(1, "solved sub-optimally, objective: ", objective);
@@ -187,33 +382,154 @@ Solution Planner::solve(std::string& additional_info)
     solver_info(1, "timeout");
   }
 
-  // logging
+  // logging, keys also in get_cache_hit_info of lacam2.cpp
   additional_info +=
       "optimal=" + std::to_string(H_goal != nullptr && OPEN.empty()) + "\n";
   additional_info += "objective=" + std::to_string(objective) + "\n";
+  additional_info +=
+      "successor_order=" + std::to_string(options.successor_order) + "\n";
+  additional_info += "num_threads=" + std::to_string(workers.size()) + "\n";
+  if (D.mode != DIST_BFS) {
+    additional_info += "dist_mode=" + std::to_string(D.mode) + "\n";
+    additional_info +=
+        "dist_table_bytes=" + std::to_string(D.memory_usage()) + "\n";
+    if (D.mode == DIST_BOUNDED) {
+      additional_info +=
+          "dist_lower_bounds=" + std::to_string(D.num_lower_bounds) + "\n";
+    }
+  }
   additional_info += "loop_cnt=" + std::to_string(loop_cnt) + "\n";
+  additional_info += "time_setup_ms=" + std::to_string(time_setup_ms) + "\n";
+  if (H_goal != nullptr) {
+    additional_info += "time_first_solution_ms=" +
+                       std::to_string(time_first_solution_ms) + "\n";
+  }
+  additional_info += "time_search_ms=" + std::to_string(time_search_ms) + "\n";
   additional_info += "num_node_gen=" + std::to_string(EXPLORED.size()) + "\n";
+  additional_info +=
+      "num_node_compacted=" + std::to_string(num_node_compacted) + "\n";
+  if (cold != nullptr) {
+    additional_info +=
+        "num_node_spilled=" + std::to_string(cold->num_spilled) + "\n";
+    additional_info += "cold_runs=" + std::to_string(cold->runs.size()) + "\n";
+    additional_info +=
+        "cold_merges=" + std::to_string(cold->num_merges) + "\n";
+    additional_info +=
+        "cold_disk_bytes=" + std::to_string(cold->disk_usage()) + "\n";
+    additional_info +=
+        "cold_block_reads=" + std::to_string(cold->num_block_reads) + "\n";
+    additional_info +=
+        "cold_bloom_rejects=" + std::to_string(cold->num_bloom_rejects) + "\n";
+    additional_info += "cold_failed=" + std::to_string(cold_failed) + "\n";
+  }
+  if (options.perf) additional_info += perf.get_stats();
+  if (heatmap != nullptr) {
+    for (auto w : workers) {
+      heatmap->add_by_id(Heatmap::CONFLICTS, w->vertex_conflicts);
+      heatmap->add_by_id(Heatmap::PUSHES, w->vertex_pushes);
+    }
+  }
+  if (options.pibt_stats) {
+    auto stats = PIBTStats();
+    for (auto w : workers) stats.merge(w->stats);
+    additional_info += stats.str();
+  }
+  if (options.huge_pages) {
+    additional_info += "huge_pages_mb=" +
+                       std::to_string((HugePages::bytes_hugetlb +
+                                       HugePages::bytes_thp) >> 20) +
+                       "\n";
+  }
 
   // memory management
-  for (auto a : A) delete a;
-  for (auto itr : EXPLORED) delete itr.second;
+  hot_nodes.clear();
+  for (auto w : workers) w->reset();
+  for (auto H : EXPLORED.nodes) delete H;
 
   return solution;
 }
 
-void Planner::rewrite(HNode* H_from, HNode* H_to, HNode* H_goal,
-                      std::stack<HNode*>& OPEN)
+void Planner::compact(Explored<HNode>& EXPLORED, HNode* H_goal)
+{
+  // low-level search trees of other workers refer to freed nodes
+  for (auto w : workers) w->reset();
+  uint cnt = 0;
+  for (auto H : EXPLORED.nodes) {
+    if (H->f < H_goal->f || H->is_compacted()) continue;
+    H->compact();
+    ++cnt;
+  }
+  num_node_compacted += cnt;
+  solver_info(2, "compaction, freed: ", cnt,
+              " nodes, total: ", num_node_compacted);
+}
+
+bool Planner::spill(Explored<HNode>& EXPLORED)
+{
+  // older half of configurations in memory
+  auto entries = std::vector<std::pair<uint64_t, const Config*> >();
+  auto nodes = HNodes();
+  auto num_entries = EXPLORED.num_entries;
+  while (num_entries > options.hot_capacity / 2 && !hot_nodes.empty()) {
+    auto H = hot_nodes.front();
+    hot_nodes.pop_front();
+    if (H->C.empty()) continue;
+    entries.emplace_back((uint64_t)H, &H->C);
+    nodes.push_back(H);
+    --num_entries;
+  }
+  if (!cold->spill(entries)) {
+    // keep everything in memory from now on
+    solver_info(1, "failed to spill to ", options.cold_dir,
+                ", keep explored configurations in memory");
+    hot_nodes.clear();
+    return false;
+  }
+  // stubs remain for links and costs
+  for (auto H : nodes) {
+    EXPLORED.erase(H, EXPLORED.get_hash(H->C));
+    H->compact();
+    Config().swap(H->C);
+  }
+  for (auto w : workers) w->reset();
+  solver_info(2, "spill ", nodes.size(), " configurations, total: ",
+              cold->num_spilled);
+  return true;
+}
+
+bool Planner::load(Explored<HNode>& EXPLORED, HNode* H)
+{
+  if (!cold->read((uint64_t)H, H->C)) {
+    // keep the stub as it is, an empty configuration is never restored
+    solver_info(1, "failed to read a configuration from ", options.cold_dir,
+                ", stop search");
+    return false;
+  }
+  EXPLORED.restore(H, EXPLORED.get_hash(H->C));
+  hot_nodes.push_back(H);
+  return true;
+}
+
+HNode* Planner::find_cold(const Config& C)
+{
+  uint64_t id;
+  if (cold == nullptr || !cold->find(C, id)) return nullptr;
+  return (HNode*)id;
+}
+
+void Planner::rewrite(HNode* H_from, HNode* H_to, const uint cost,
+                      HNode* H_goal, std::stack<HNode*>& OPEN)
 {
   // update neighbors
-  H_from->neighbor.insert(H_to);
+  H_from->neighbor.emplace(H_to, cost);
 
   // Dijkstra update
   std::queue<HNode*> Q({H_from});  // queue is sufficient
   while (!Q.empty()) {
     auto n_from = Q.front();
     Q.pop();
-    for (auto n_to : n_from->neighbor) {
-      auto g_val = n_from->g + get_edge_cost(n_from->C, n_to->C);
+    for (auto [n_to, edge_cost] : n_from->neighbor) {
+      auto g_val = n_from->g + edge_cost;
       if (g_val < n_to->g) {
         if (n_to == H_goal)
           solver_info(1, "cost update: ", n_to->g, " -> ", g_val);
@@ -277,52 +593,196 @@ void Planner::expand_lowlevel_tree(HNode* H, LNode* L)
   C.push_back(H->C[i]);
   // randomize
   if (MT != nullptr) std::shuffle(C.begin(), C.end(), *MT);
+  // closer to the goal first, keeping random tie-breaking
+  // distances are evaluated once, bounded rows may tighten in between
+  if (options.successor_order == ORDER_DIST) {
+    auto keys = std::vector<std::pair<uint, Vertex*> >();
+    for (auto v : C) keys.emplace_back(D.get(i, v), v);
+    std::stable_sort(keys.begin(), keys.end(), [&](auto& a, auto& b) {
+      return a.first < b.first;
+    });
+    for (size_t k = 0; k < C.size(); ++k) C[k] = keys[k].second;
+  }
   // insert
-  for (auto v : C) H->search_tree.push(new LNode(L, i, v));
+  for (auto v : C) {
+    H->lnodes.push_back(new LNode(L, i, v));
+    H->search_tree.push(H->lnodes.back());
+  }
+}
+
+PIBTStats::PIBTStats()
+    : num_calls(0),
+      num_fail_constraints(0),
+      num_fail_pibt(0),
+      chain_depth(),
+      num_candidates(),
+      depth_at_fail(1024)
+{
 }
 
-bool Planner::get_new_config(HNode* H, LNode* L)
+void PIBTStats::merge(const PIBTStats& other)
 {
+  num_calls += other.num_calls;
+  num_fail_constraints += other.num_fail_constraints;
+  num_fail_pibt += other.num_fail_pibt;
+  chain_depth.merge(other.chain_depth);
+  num_candidates.merge(other.num_candidates);
+  depth_at_fail.merge(other.depth_at_fail);
+}
+
+std::string PIBTStats::str() const
+{
+  const auto num_fail = num_fail_constraints + num_fail_pibt;
+  auto s = std::string();
+  s += "pibt_calls=" + std::to_string(num_calls) + "\n";
+  s += "pibt_fail_constraints=" + std::to_string(num_fail_constraints) + "\n";
+  s += "pibt_fail_pibt=" + std::to_string(num_fail_pibt) + "\n";
+  s += "pibt_fail_rate=" +
+       std::to_string(num_calls == 0 ? 0 : (double)num_fail / num_calls) + "\n";
+  s += "pibt_chain_depth_mean=" + std::to_string(chain_depth.mean()) + "\n";
+  s += "pibt_chain_depth_hist=" + chain_depth.str() + "\n";
+  s += "pibt_candidates_hist=" + num_candidates.str() + "\n";
+  s += "pibt_lowlevel_depth_at_fail_hist=" + depth_at_fail.str() + "\n";
+  return s;
+}
+
+PIBT::PIBT(const Instance* _ins, DistTable& _D, std::mt19937* _MT,
+           const PlannerOptions& options)
+    : ins(_ins),
+      D(_D),
+      MT(_MT),
+      N(ins->N),
+      V_size(ins->G.size()),
+      C_next(N),
+      tie_breakers(V_size, 0, HugeAllocator<float>(options.huge_pages)),
+      A(N, nullptr),
+      occupied_now(V_size, nullptr, HugeAllocator<Agent*>(options.huge_pages)),
+      occupied_next(V_size, nullptr,
+                    HugeAllocator<Agent*>(options.huge_pages)),
+      H_applied(nullptr),
+      L_applied(nullptr),
+      diagnostics(options.pibt_stats),
+      stats(),
+      chain_depth_now(0),
+      chain_depth_max(0)
+{
+  for (uint i = 0; i < N; ++i) A[i] = new Agent(i);
+}
+
+PIBT::~PIBT()
+{
+  for (auto a : A) delete a;
+}
+
+void PIBT::reset()
+{
+  H_applied = nullptr;
+  L_applied = nullptr;
+}
+
+bool PIBT::get_new_config(HNode* H, LNode* L)
+{
+  if (diagnostics) ++stats.num_calls;
+
   // setup cache
-  for (auto a : A) {
-    // clear previous cache
-    if (a->v_now != nullptr && occupied_now[a->v_now->id] == a) {
-      occupied_now[a->v_now->id] = nullptr;  // 高效初始化
+  if (H != H_applied) {
+    for (auto a : A) {
+      // clear previous cache
+      if (a->v_now != nullptr && occupied_now[a->v_now->id] == a) {
+        occupied_now[a->v_now->id] = nullptr;  // 高效初始化
+      }
+      if (a->v_next != nullptr) {
+        occupied_next[a->v_next->id] = nullptr;
+        a->v_next = nullptr;
+      }
+
+      // set occupied now
+      a->v_now = H->C[a->id];
+      occupied_now[a->v_now->id] = a;
     }
-    if (a->v_next != nullptr) {
-      occupied_next[a->v_next->id] = nullptr;
+    H_applied = H;
+    L_applied = nullptr;
+  } else {
+    // same high-level node, undo only the previous PIBT
+    for (auto a : pibt_placed) {
+      if (a->v_next == nullptr) continue;
+      if (occupied_next[a->v_next->id] == a)
+        occupied_next[a->v_next->id] = nullptr;
       a->v_next = nullptr;
     }
-
-    // set occupied now
-    a->v_now = H->C[a->id];
-    occupied_now[a->v_now->id] = a;
   }
+  pibt_placed.clear();
+
+  // update constraints from L_applied to L, via their common ancestor
+  auto get_depth = [](LNode* n) { return n == nullptr ? 0 : n->depth; };
+  auto undo_constraint = [&](LNode* n) {
+    A[n->who]->v_next = nullptr;
+    occupied_next[n->where->id] = nullptr;
+  };
+  LNode* L_from = L_applied;
+  LNode* L_to = L;
+  constraints.clear();
+  while (get_depth(L_from) > get_depth(L_to)) {
+    undo_constraint(L_from);
+    L_from = L_from->parent;
+  }
+  while (get_depth(L_to) > get_depth(L_from)) {
+    constraints.push_back(L_to);
+    L_to = L_to->parent;
+  }
+  while (get_depth(L_from) > 0 && L_from != L_to) {
+    undo_constraint(L_from);
+    L_from = L_from->parent;
+    constraints.push_back(L_to);
+    L_to = L_to->parent;
+  }
+  L_applied = L_from;
 
   // add constraints
-  LNode* tmp = L;
-  for (uint k = 0; k < L->depth; ++k) {
-    const auto i = tmp->who;        // agent
-    const auto l = tmp->where->id;  // loc
+  for (size_t k = 0; k < constraints.size(); ++k) {
+    const auto i = constraints[k]->who;        // agent
+    const auto l = constraints[k]->where->id;  // loc
 
     // check vertex collision
-    if (occupied_next[l] != nullptr) return false;
+    auto collision = occupied_next[l] != nullptr;
     // check swap collision
     auto l_pre = H->C[i]->id;
     if (occupied_next[l_pre] != nullptr && occupied_now[l] != nullptr &&
         occupied_next[l_pre]->id == occupied_now[l]->id)
+      collision = true;
+
+    if (collision) {
+      // rollback to the common ancestor, which is known to be consistent
+      for (size_t j = 0; j < k; ++j) undo_constraint(constraints[j]);
+      if (diagnostics) {
+        ++stats.num_fail_constraints;
+        stats.depth_at_fail.add(L->depth);
+      }
       return false;
+    }
 
     // set occupied_next
-    A[i]->v_next = tmp->where;
+    A[i]->v_next = constraints[k]->where;
     occupied_next[l] = A[i];
-    tmp = tmp -> parent;
   }
+  L_applied = L;
 
   // perform PIBT
   for (auto k : H->order) {
     auto a = A[k];
-    if (a->v_next == nullptr && !funcPIBT(a)) return false;  // planning failure
+    if (a->v_next != nullptr) continue;
+    chain_depth_max = 0;
+    const auto res = funcPIBT(a);
+    if (diagnostics) stats.chain_depth.add(chain_depth_max);
+    if (!res) {
+      // planning failure, occupied_next may be overwritten -> reset next time
+      H_applied = nullptr;
+      if (diagnostics) {
+        ++stats.num_fail_pibt;
+        stats.depth_at_fail.add(L->depth);
+      }
+      return false;
+    }
   }
   return true;
 }
@@ -341,10 +801,14 @@ bool Planner::get_new_config(HNode* H, LNode* L)
 //  return ret;
 //}
 
-bool Planner::funcPIBT(Agent* ai) // PIBT*
+bool PIBT::funcPIBT(Agent* ai) // PIBT*
 {
   const auto i = ai->id;
+  pibt_placed.push_back(ai);
   const auto K = ai->v_now->neighbor.size();
+  if (diagnostics) {
+    chain_depth_max = std::max(chain_depth_max, ++chain_depth_now);
+  }
 
   // get candidates for next locations
   for (auto k = 0; k < K; ++k) {
@@ -358,12 +822,15 @@ bool Planner::funcPIBT(Agent* ai) // PIBT*
   }
   C_next[i][K] = ai->v_now;
 //  tie_breakers[ai->v_now->id] = get_random_float(MT, 0, 0.49);
-  // sort
-  std::sort(C_next[i].begin(), C_next[i].begin() + K + 1,
-            [&](Vertex* const v, Vertex* const u) {
-              return (float)D.get(i, v)  + tie_breakers[v->id] <
-                     (float)D.get(i, u)  +tie_breakers[u->id];
-            });
+  // sort, distances are evaluated once since bounded rows may tighten
+  std::array<std::pair<float, Vertex*>, 5> keys;
+  for (size_t k = 0; k <= K; ++k) {
+    const auto v = C_next[i][k];
+    keys[k] = {(float)D.get(i, v) + tie_breakers[v->id], v};
+  }
+  std::sort(keys.begin(), keys.begin() + K + 1,
+            [&](auto& a, auto& b) { return a.first < b.first; });
+  for (size_t k = 0; k <= K; ++k) C_next[i][k] = keys[k].second;
 
   Agent* swap_agent = nullptr;
   if (FLG_SWAP) {
@@ -377,20 +844,28 @@ bool Planner::funcPIBT(Agent* ai) // PIBT*
     auto u = C_next[i][k]; // 备用节点
 
     // avoid vertex conflicts
-    if (occupied_next[u->id] != nullptr) continue; // 节点u下一时刻将被占据
+    if (occupied_next[u->id] != nullptr) { // 节点u下一时刻将被占据
+      if (!vertex_conflicts.empty()) ++vertex_conflicts[u->id];
+      continue;
+    }
 
     auto& ak = occupied_now[u->id]; // 选取当前占据u节点的agent
 
     // avoid swap conflicts
-    if (ak != nullptr && ak->v_next == ai->v_now) continue; // 如果该agent下一时刻要来到当前位置，swap conflict
+    if (ak != nullptr && ak->v_next == ai->v_now) { // 如果该agent下一时刻要来到当前位置，swap conflict
+      if (!vertex_conflicts.empty()) ++vertex_conflicts[u->id];
+      continue;
+    }
 
     // reserve next location
     occupied_next[u->id] = ai; // 不会发生任何冲突
     ai->v_next = u;
 
     // priority inheritance
-    if (ak != nullptr && ak != ai && ak->v_next == nullptr && !funcPIBT(ak))
-      continue;
+    if (ak != nullptr && ak != ai && ak->v_next == nullptr) {
+      if (!vertex_pushes.empty()) ++vertex_pushes[u->id];
+      if (!funcPIBT(ak)) continue;
+    }
 
     // success to plan next one step
     // pull swap_agent when applicable
@@ -399,18 +874,27 @@ bool Planner::funcPIBT(Agent* ai) // PIBT*
           occupied_next[ai->v_now->id] == nullptr) {
         swap_agent->v_next = ai->v_now;
         occupied_next[swap_agent->v_next->id] = swap_agent;
+        pibt_placed.push_back(swap_agent);
       }
     }
+    if (diagnostics) {
+      --chain_depth_now;
+      stats.num_candidates.add(k + 1);
+    }
     return true;
   }
 
   // failed to secure node
   occupied_next[ai->v_now->id] = ai; // why? 停留原地的选项不是也已经进行过尝试了吗？
   ai->v_next = ai->v_now;
+  if (diagnostics) {
+    --chain_depth_now;
+    stats.num_candidates.add(K + 1);
+  }
   return false;
 }
 
-Agent* Planner::swap_possible_and_required(Agent* ai)
+Agent* PIBT::swap_possible_and_required(Agent* ai)
 {
   const auto i = ai->id;
   // ai wanna stay at v_now -> no need to swap
@@ -438,7 +922,7 @@ Agent* Planner::swap_possible_and_required(Agent* ai)
 }
 
 // simulate whether the swap is required
-bool Planner::is_swap_required(const uint pusher, const uint puller,
+bool PIBT::is_swap_required(const uint pusher, const uint puller,
                                Vertex* v_pusher_origin, Vertex* v_puller_origin)
 {
   auto v_pusher = v_pusher_origin;
@@ -469,7 +953,7 @@ bool Planner::is_swap_required(const uint pusher, const uint puller,
 }
 
 // simulate whether the swap is possible
-bool Planner::is_swap_possible(Vertex* v_pusher_origin, Vertex* v_puller_origin)
+bool PIBT::is_swap_possible(Vertex* v_pusher_origin, Vertex* v_puller_origin)
 {
   auto v_pusher = v_pusher_origin;
   auto v_puller = v_puller_origin;
@@ -504,3 +988,13 @@ std::ostream& operator<<(std::ostream& os, const Objective obj)
   }
   return os;
 }
+
+std::ostream& operator<<(std::ostream& os, const SuccessorOrder order)
+{
+  if (order == ORDER_RANDOM) {
+    os << "random";
+  } else if (order == ORDER_DIST) {
+    os << "dist";
+  }
+  return os;
+}
@@ -0,0 +1,340 @@
+#include "../include/portfolio.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <sstream>
+
+#include "../include/lacam2.hpp"
+
+namespace
+{
+
+struct Connection {
+  int fd;
+  std::string buf;  // received, not yet a complete line
+  int config;       // running, -1 -> idle
+};
+
+bool send_line(const int fd, const std::string& line)
+{
+  for (size_t sent = 0; sent < line.size();) {
+    const auto res =
+        send(fd, line.data() + sent, line.size() - sent, MSG_NOSIGNAL);
+    if (res <= 0) return false;
+    sent += res;
+  }
+  return true;
+}
+
+// appends complete lines; false on EOF or error
+bool recv_lines(Connection& c, std::vector<std::string>& lines)
+{
+  char chunk[1 << 16];
+  const auto res = recv(c.fd, chunk, sizeof(chunk), 0);
+  if (res <= 0) return false;
+  c.buf.append(chunk, res);
+  size_t begin = 0;
+  for (auto end = c.buf.find('\n'); end != std::string::npos;
+       end = c.buf.find('\n', begin)) {
+    lines.push_back(c.buf.substr(begin, end - begin));
+    begin = end + 1;
+  }
+  c.buf.erase(0, begin);
+  return true;
+}
+
+}  // namespace
+
+Portfolio::Portfolio(const Instance& _ins,
+                     const std::vector<PortfolioConfig>& _configs,
+                     const PortfolioMode _mode, const int _port,
+                     const int _verbose, const PlannerOptions& _options)
+    : ins(_ins),
+      configs(_configs),
+      mode(_mode),
+      port(_port),
+      verbose(_verbose),
+      options(_options),
+      solution(),
+      winner(-1),
+      num_results(0),
+      num_workers(0)
+{
+}
+
+bool Portfolio::is_better(const Solution& a, const Solution& b) const
+{
+  if (b.empty()) return !a.empty();
+  if (a.empty()) return false;
+  if (configs.front().objective == OBJ_MAKESPAN) {
+    return get_makespan(a) < get_makespan(b);
+  }
+  return get_sum_of_loss(a) < get_sum_of_loss(b);
+}
+
+Solution Portfolio::coordinate(const Deadline* deadline, const uint num_local,
+                               std::string& additional_info)
+{
+  // listen on loopback
+  const auto listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+  const int one = 1;
+  setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons(port);
+  socklen_t addr_len = sizeof(addr);
+  if (bind(listen_fd, (sockaddr*)&addr, sizeof(addr)) != 0 ||
+      listen(listen_fd, 64) != 0 ||
+      getsockname(listen_fd, (sockaddr*)&addr, &addr_len) != 0) {
+    info(0, verbose, "failed to listen on port ", port);
+    close(listen_fd);
+    return Solution();
+  }
+  port = ntohs(addr.sin_port);
+  info(1, verbose, "portfolio: listening on 127.0.0.1:", port);
+
+  // local workers, sharing the loaded instance
+  auto pids = std::vector<pid_t>();
+  for (uint k = 0; k < num_local; ++k) {
+    const auto pid = fork();
+    if (pid == 0) {
+      close(listen_fd);
+      if (options.numa) Numa::pin_thread(Numa::node_of_worker(k));
+      _exit(portfolio_worker(ins, "127.0.0.1", port, verbose - 1, options));
+    }
+    if (pid > 0) pids.push_back(pid);
+  }
+
+  auto conns = std::vector<Connection>();
+  size_t next_config = 0;
+  auto assign = [&](Connection& c) {
+    if (next_config >= configs.size()) {
+      send_line(c.fd, "BYE\n");
+      return;
+    }
+    const auto& cfg = configs[next_config];
+    const auto rest_ms =
+        deadline == nullptr
+            ? 3600000.0
+            : std::max(1.0, deadline->time_limit_ms - deadline->elapsed_ms());
+    std::stringstream ss;
+    ss << "SOLVE " << next_config << " " << cfg.seed << " " << cfg.restart_rate
+       << " " << static_cast<int>(cfg.objective) << " " << rest_ms << "\n";
+    if (send_line(c.fd, ss.str())) c.config = next_config++;
+  };
+  // false when the result is not of the job running on c, then ignored
+  auto on_result = [&](Connection& c, const std::string& line) {
+    std::istringstream iss(line.substr(7));
+    int id = -1, solved = 0;
+    double comp_time_ms = 0;
+    size_t T = 0, N = 0;
+    iss >> id >> solved >> comp_time_ms >> T >> N;
+    if (!iss || id < 0 || id >= (int)configs.size() || id != c.config) {
+      info(1, verbose, "portfolio: unexpected result for config ", id);
+      return false;
+    }
+    c.config = -1;
+    ++num_results;
+    if (!solved || N != ins.N) return true;
+    auto sol = Solution(T, Config(N, nullptr));
+    for (auto& C : sol) {
+      for (auto& v : C) {
+        uint index;
+        iss >> index;
+        if (!iss || index >= ins.G.U.size() || ins.G.U[index] == nullptr) {
+          info(1, verbose, "portfolio: invalid cell in result of config ", id);
+          return true;
+        }
+        v = ins.G.U[index];
+      }
+    }
+    if (!is_feasible_solution(ins, sol)) {
+      info(1, verbose, "portfolio: infeasible result of config ", id);
+      return true;
+    }
+    info(1, verbose, "portfolio: config ", id, " solved in ", comp_time_ms,
+         "ms, sum_of_loss=", get_sum_of_loss(sol));
+    if (is_better(sol, solution)) {
+      solution = sol;
+      winner = id;
+    }
+    return true;
+  };
+
+  // after the deadline, busy workers are cancelled and get a grace period
+  // to report their best solutions so far
+  constexpr double GRACE_MS = 1000;
+  auto cancelled_at = -1.0;
+  auto is_busy = [](const Connection& c) { return c.config >= 0; };
+  auto done = false;
+  while (!done) {
+    if (cancelled_at < 0 && is_expired(deadline)) {
+      for (auto& c : conns) {
+        if (is_busy(c)) send_line(c.fd, "CANCEL\n");
+      }
+      next_config = configs.size();
+      cancelled_at = elapsed_ms(deadline);
+    }
+    if (cancelled_at >= 0 &&
+        (std::none_of(conns.begin(), conns.end(), is_busy) ||
+         elapsed_ms(deadline) > cancelled_at + GRACE_MS)) {
+      break;
+    }
+    auto fds = std::vector<pollfd>({{listen_fd, POLLIN, 0}});
+    for (auto& c : conns) fds.push_back({c.fd, POLLIN, 0});
+    if (poll(fds.data(), fds.size(), 10) <= 0) continue;
+    if (fds[0].revents & POLLIN) {
+      const auto fd = accept(listen_fd, nullptr, nullptr);
+      if (fd >= 0) {
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        conns.push_back({fd, "", -1});
+        ++num_workers;
+      }
+    }
+    for (size_t k = 1; k < fds.size() && !done; ++k) {
+      if (!(fds[k].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+      auto& c = conns[k - 1];
+      auto lines = std::vector<std::string>();
+      if (!recv_lines(c, lines)) {
+        if (is_busy(c)) ++num_results;  // lost
+        close(c.fd);
+        c.fd = -1;
+        continue;
+      }
+      for (auto& line : lines) {
+        if (line == "HELLO") {
+          assign(c);
+        } else if (line.rfind("RESULT ", 0) == 0) {
+          if (!on_result(c, line)) continue;
+          if (mode == PORTFOLIO_FIRST && winner >= 0) {
+            done = true;
+            break;
+          }
+          assign(c);
+        }
+      }
+    }
+    conns.erase(std::remove_if(conns.begin(), conns.end(),
+                               [](const Connection& c) { return c.fd < 0; }),
+                conns.end());
+    if (num_results >= configs.size()) done = true;
+
+    // without a deadline, stop once every worker has gone
+    if (deadline == nullptr && conns.empty() &&
+        (num_workers > 0 || !pids.empty())) {
+      for (auto& pid : pids) {
+        if (pid > 0 && waitpid(pid, nullptr, WNOHANG) == pid) pid = -1;
+      }
+      if (std::all_of(pids.begin(), pids.end(),
+                      [](const pid_t pid) { return pid < 0; })) {
+        info(1, verbose, "portfolio: all workers have gone");
+        break;
+      }
+    }
+  }
+
+  // cancellation, then shutdown
+  for (auto& c : conns) {
+    if (is_busy(c) && cancelled_at < 0) send_line(c.fd, "CANCEL\n");
+    send_line(c.fd, "BYE\n");
+    close(c.fd);
+  }
+  close(listen_fd);
+  for (auto pid : pids) {
+    if (pid > 0) waitpid(pid, nullptr, 0);
+  }
+
+  additional_info += "portfolio_workers=" + std::to_string(num_workers) + "\n";
+  additional_info += "portfolio_results=" + std::to_string(num_results) + "\n";
+  if (winner >= 0) {
+    const auto& cfg = configs[winner];
+    additional_info += "portfolio_seed=" + std::to_string(cfg.seed) + "\n";
+    additional_info +=
+        "portfolio_restart_rate=" + std::to_string(cfg.restart_rate) + "\n";
+    additional_info +=
+        "portfolio_objective=" + std::to_string(cfg.objective) + "\n";
+  }
+  return solution;
+}
+
+int portfolio_worker(const Instance& ins, const std::string& host,
+                     const int port, const int verbose,
+                     const PlannerOptions& options)
+{
+  const auto fd = socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  if (inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1 ||
+      connect(fd, (sockaddr*)&addr, sizeof(addr)) != 0) {
+    info(0, verbose, "failed to connect to ", host, ":", port);
+    close(fd);
+    return 1;
+  }
+  const int one = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  send_line(fd, "HELLO\n");
+
+  auto c = Connection{fd, "", -1};
+  auto quit = false;
+  while (!quit) {
+    auto lines = std::vector<std::string>();
+    if (!recv_lines(c, lines)) break;
+    for (auto& line : lines) {
+      if (line == "BYE") {
+        quit = true;
+        break;
+      }
+      if (line.rfind("SOLVE ", 0) != 0) continue;  // e.g., late CANCEL
+      std::istringstream iss(line.substr(6));
+      int id, seed, objective;
+      float restart_rate;
+      double time_limit_ms;
+      iss >> id >> seed >> restart_rate >> objective >> time_limit_ms;
+
+      // solve in another thread, listening for cancellation
+      const auto deadline = Deadline(time_limit_ms);
+      auto solution = Solution();
+      std::atomic<bool> finished = false;
+      auto solver = std::thread([&]() {
+        auto MT = std::mt19937(seed);
+        auto additional_info = std::string();
+        solution = solve(ins, additional_info, verbose - 1, &deadline, &MT,
+                         static_cast<Objective>(objective), restart_rate,
+                         nullptr, nullptr, nullptr, options);
+        finished = true;
+      });
+      while (!finished) {
+        pollfd pfd = {fd, POLLIN, 0};
+        if (poll(&pfd, 1, 10) <= 0) continue;
+        auto msgs = std::vector<std::string>();
+        const auto alive = recv_lines(c, msgs);
+        for (auto& msg : msgs) quit |= (msg == "BYE");
+        if (!alive || quit || !msgs.empty()) deadline.cancel();
+        if (!alive) quit = true;
+      }
+      solver.join();
+      info(1, verbose, "worker: config ", id, " solved=", !solution.empty(),
+           " in ", deadline.elapsed_ms(), "ms");
+      if (quit) break;
+
+      std::stringstream ss;
+      ss << "RESULT " << id << " " << !solution.empty() << " "
+         << deadline.elapsed_ms() << " " << solution.size() << " " << ins.N;
+      for (auto& C : solution) {
+        for (auto v : C) ss << " " << v->index;
+      }
+      ss << "\n";
+      if (!send_line(fd, ss.str())) quit = true;
+    }
+  }
+  close(fd);
+  return 0;
+}
@@ -1,12 +1,14 @@
 #include "../include/post_processing.hpp"
 
+#include <sstream>
+
 #include "../include/dist_table.hpp"
+#include "../include/json.hpp"
 
 bool is_feasible_solution(uint& offgoals, uint& badmoves, const Instance& ins, const Solution& solution,
                           const int verbose)
 {
   if (solution.empty()) return true;
-  auto dist_table = DistTable(ins);
 
   // check start locations
   if (!is_same_config(solution.front(), ins.starts)) {
@@ -20,7 +22,20 @@ bool is_feasible_solution(uint& offgoals, uint& badmoves, const Instance& ins, c
     return false;
   }
 
+  // occupancy tables, agent-id + 1 (0: empty), stamped by timestep
+  const auto V_size = ins.G.size();
+  auto occupied_pre = std::vector<uint>(V_size, 0);
+  auto occupied_now = std::vector<uint>(V_size, 0);
+  auto stamp_pre = std::vector<size_t>(V_size, 0);
+  auto stamp_now = std::vector<size_t>(V_size, 0);
+  for (size_t i = 0; i < ins.N; ++i) {
+    occupied_now[solution[0][i]->id] = i + 1;
+    stamp_now[solution[0][i]->id] = 1;
+  }
+
   for (size_t t = 1; t < solution.size(); ++t) {
+    std::swap(occupied_pre, occupied_now);
+    std::swap(stamp_pre, stamp_now);
     for (size_t i = 0; i < ins.N; ++i) {
       auto v_i_from = solution[t - 1][i];
       auto v_i_to = solution[t][i];
@@ -32,26 +47,30 @@ bool is_feasible_solution(uint& offgoals, uint& badmoves, const Instance& ins, c
 
       // check connectivity
       if (v_i_from != v_i_to &&
-          std::find(v_i_to->neighbor.begin(), v_i_to->neighbor.end(),
-                    v_i_from) == v_i_to->neighbor.end()) {
+          std::find(v_i_from->neighbor.begin(), v_i_from->neighbor.end(),
+                    v_i_to) == v_i_from->neighbor.end()) {
         info(1, verbose, "invalid move");
         return false;
       }
 
-      // check conflicts
-      for (size_t j = i + 1; j < ins.N; ++j) {
-        auto v_j_from = solution[t - 1][j];
-        auto v_j_to = solution[t][j];
-        // vertex conflicts
-        if (v_j_to == v_i_to) {
-          info(1, verbose, "vertex conflict");
-          return false;
-        }
-        // swap conflicts
-        if (v_j_to == v_i_from && v_j_from == v_i_to) {
-          info(1, verbose, "edge conflict");
-          return false;
-        }
+      // vertex conflicts
+      if (stamp_now[v_i_to->id] == t + 1) {
+        info(1, verbose, "vertex conflict");
+        return false;
+      }
+      occupied_now[v_i_to->id] = i + 1;
+      stamp_now[v_i_to->id] = t + 1;
+    }
+
+    // swap conflicts
+    for (size_t i = 0; i < ins.N; ++i) {
+      auto v_i_from = solution[t - 1][i];
+      auto v_i_to = solution[t][i];
+      if (v_i_from == v_i_to || stamp_pre[v_i_to->id] != t) continue;
+      const auto j = occupied_pre[v_i_to->id] - 1;
+      if (solution[t][j] == v_i_from) {
+        info(1, verbose, "edge conflict");
+        return false;
       }
     }
   }
@@ -59,6 +78,13 @@ bool is_feasible_solution(uint& offgoals, uint& badmoves, const Instance& ins, c
   return true;
 }
 
+bool is_feasible_solution(const Instance& ins, const Solution& solution,
+                          const int verbose)
+{
+  uint offgoals = 0, badmoves = 0;
+  return is_feasible_solution(offgoals, badmoves, ins, solution, verbose);
+}
+
 int get_makespan(const Solution& solution)
 {
   if (solution.empty()) return 0;
@@ -137,10 +163,10 @@ void print_stats(const int verbose, const Instance& ins,
 // for log of map_name
 static const std::regex r_map_name = std::regex(R"(.+/(.+))");
 
-void make_log(const Instance& ins, const Solution& solution,
-              const std::string& output_name, const double comp_time_ms,
-              const std::string& map_name, const int seed,
-              const std::string& additional_info, const bool log_short)
+std::string get_log_stats(const Instance& ins, const Solution& solution,
+                          const double comp_time_ms,
+                          const std::string& map_name, const int seed,
+                          const std::string& additional_info)
 {
   // map name
   std::smatch results;
@@ -151,11 +177,7 @@ void make_log(const Instance& ins, const Solution& solution,
   // for instance-specific values
   auto dist_table = DistTable(ins);
 
-  // log for visualizer
-  auto get_x = [&](int k) { return k % ins.G.width; };
-  auto get_y = [&](int k) { return k / ins.G.width; };
-  std::ofstream log;
-  log.open(output_name, std::ios::out);
+  std::stringstream log;
   log << "agents=" << ins.N << "\n";
   log << "map_file=" << map_recorded_name << "\n";
   log << "solver=planner\n";
@@ -170,6 +192,30 @@ void make_log(const Instance& ins, const Solution& solution,
   log << "comp_time=" << comp_time_ms << "\n";
   log << "seed=" << seed << "\n";
   log << additional_info;
+  return log.str();
+}
+
+void make_log(const Instance& ins, const Solution& solution,
+              const std::string& output_name, const double comp_time_ms,
+              const std::string& map_name, const int seed,
+              const std::string& additional_info, const bool log_short)
+{
+  make_log(ins, solution, output_name,
+           get_log_stats(ins, solution, comp_time_ms, map_name, seed,
+                         additional_info),
+           log_short);
+}
+
+void make_log(const Instance& ins, const Solution& solution,
+              const std::string& output_name, const std::string& stats,
+              const bool log_short)
+{
+  // log for visualizer
+  auto get_x = [&](int k) { return k % ins.G.width; };
+  auto get_y = [&](int k) { return k / ins.G.width; };
+  std::ofstream log;
+  log.open(output_name, std::ios::out);
+  log << stats;
   if (log_short) return;
   log << "starts=";
   for (size_t i = 0; i < ins.N; ++i) {
@@ -192,3 +238,160 @@ void make_log(const Instance& ins, const Solution& solution,
   }
   log.close();
 }
+
+void make_json_log(const Instance& ins, const Solution& solution,
+                   const std::string& output_name, const std::string& stats,
+                   const std::vector<std::pair<std::string, double> >& timings,
+                   const bool log_short, const bool append)
+{
+  auto json = JsonWriter();
+  json.buf.reserve(1024 + (log_short ? 0 : solution.size() * ins.N * 10));
+  json.begin_object();
+
+  // key=value lines of make_log
+  size_t pos = 0;
+  while (pos < stats.size()) {
+    auto eol = stats.find('\n', pos);
+    if (eol == std::string::npos) eol = stats.size();
+    const auto eq = stats.find('=', pos);
+    if (eq != std::string::npos && eq < eol) {
+      json.key(stats.substr(pos, eq - pos));
+      json.value_of_text(stats.substr(eq + 1, eol - eq - 1));
+    }
+    pos = eol + 1;
+  }
+
+  if (!timings.empty()) {
+    json.key("timing").begin_object();
+    for (auto& [name, ms] : timings) json.key(name).value(ms);
+    json.end_object();
+  }
+
+  if (!log_short) {
+    // locations as [x, y]
+    auto write_config = [&](const Config& C) {
+      json.begin_array();
+      for (auto v : C) {
+        json.begin_array();
+        json.value(v->index % ins.G.width).value(v->index / ins.G.width);
+        json.end_array();
+      }
+      json.end_array();
+    };
+    json.key("starts");
+    write_config(ins.starts);
+    json.key("goals");
+    write_config(ins.goals);
+    json.key("solution").begin_array();
+    for (auto& C : solution) write_config(C);
+    json.end_array();
+  }
+  json.end_object();
+  json.buf.push_back('\n');
+
+  std::ofstream log(output_name, append ? std::ios::app : std::ios::out);
+  log.write(json.buf.data(), json.buf.size());
+}
+
+Solution load_solution(const Instance& ins, const std::string& filename)
+{
+  static const std::regex r_loc = std::regex(R"(\((\d+),(\d+)\))");
+  auto solution = Solution();
+  std::ifstream file(filename);
+  if (!file) {
+    info(0, 0, filename, " is not found");
+    return solution;
+  }
+  std::string line;
+  while (getline(file, line) && line != "solution=") continue;
+  while (getline(file, line)) {
+    auto C = Config();
+    for (auto itr = std::sregex_iterator(line.begin(), line.end(), r_loc);
+         itr != std::sregex_iterator(); ++itr) {
+      const uint x = std::stoi((*itr)[1].str());
+      const uint y = std::stoi((*itr)[2].str());
+      if (x >= ins.G.width || y >= ins.G.height) return Solution();
+      C.push_back(ins.G.U[ins.G.width * y + x]);
+      if (C.back() == nullptr) return Solution();
+    }
+    if (C.size() != ins.N) return Solution();
+    solution.push_back(C);
+  }
+  return solution;
+}
+
+// location of agent i at t, staying after the end
+static Vertex* get_location(const Solution& solution, uint i, size_t t)
+{
+  return solution[std::min(t, solution.size() - 1)][i];
+}
+
+SolutionDiff get_solution_diff(const Solution& prev, const Solution& next)
+{
+  auto diff = SolutionDiff{(uint)next.size(), 0, {}};
+  if (next.empty()) return diff;
+  const auto N = next.front().size();
+  diff.N = N;
+  const auto comparable = !prev.empty() && prev.front().size() == N;
+  const auto T = std::max(prev.size(), next.size());
+  for (uint i = 0; i < N; ++i) {
+    size_t t = 0;
+    if (comparable) {
+      while (t < T && get_location(prev, i, t) == get_location(next, i, t)) {
+        ++t;
+      }
+      if (t == T) continue;  // unchanged
+    }
+    // until the last move
+    size_t t_last = next.size() - 1;
+    while (t_last > t && next[t_last - 1][i] == next[t_last][i]) --t_last;
+    auto path = PathDiff{i, (uint)t, Config()};
+    for (auto k = t; k <= t_last; ++k) {
+      path.suffix.push_back(get_location(next, i, k));
+    }
+    diff.paths.push_back(path);
+  }
+  return diff;
+}
+
+Solution apply_solution_diff(const Solution& prev, const SolutionDiff& diff)
+{
+  if (diff.T == 0) return Solution();
+  auto solution = Solution(diff.T, Config(diff.N, nullptr));
+  const auto comparable = !prev.empty() && prev.front().size() == diff.N;
+  for (uint i = 0; i < diff.N && comparable; ++i) {
+    for (size_t t = 0; t < diff.T; ++t) {
+      solution[t][i] = get_location(prev, i, t);
+    }
+  }
+  for (auto& path : diff.paths) {
+    const auto i = path.agent;
+    for (size_t t = path.t_diverge; t < diff.T; ++t) {
+      solution[t][i] =
+          path.suffix[std::min(t - path.t_diverge, path.suffix.size() - 1)];
+    }
+  }
+  return solution;
+}
+
+void make_diff_log(const Instance& ins, const SolutionDiff& diff,
+                   const std::string& output_name)
+{
+  auto get_x = [&](int k) { return k % ins.G.width; };
+  auto get_y = [&](int k) { return k / ins.G.width; };
+  std::ofstream log;
+  log.open(output_name, std::ios::out);
+  log << "agents=" << ins.N << "\n";
+  log << "makespan=" << (diff.T == 0 ? 0 : diff.T - 1) << "\n";
+  log << "changed=" << diff.paths.size() << "\n";
+  // agent:first divergence:new locations from there
+  log << "diff=\n";
+  for (auto& path : diff.paths) {
+    log << path.agent << ":" << path.t_diverge << ":";
+    for (auto v : path.suffix) {
+      log << "(" << get_x(v->index) << "," << get_y(v->index) << "),";
+    }
+    log << "\n";
+  }
+  log.close();
+}
@@ -0,0 +1,183 @@
+#include "../include/replan.hpp"
+
+ReservationTable::ReservationTable(const uint _V_size)
+    : V_size(_V_size),
+      entries(V_size),
+      rest_from(V_size, UINT_MAX),
+      last_use(V_size, 0),
+      T(0)
+{
+}
+
+void ReservationTable::add(const Config& path)
+{
+  if (path.empty()) return;
+  // waits at the end are covered by rest_from
+  auto t_end = path.size() - 1;
+  while (t_end > 0 && path[t_end - 1] == path[t_end]) --t_end;
+  for (size_t t = 0; t < t_end; ++t) {
+    const auto v = path[t]->id;
+    auto& E = entries[v];
+    const auto entry = std::make_pair((uint)t, path[t + 1]->id);
+    if (E.empty() || E.back() < entry) {
+      E.push_back(entry);
+    } else {
+      E.insert(std::upper_bound(E.begin(), E.end(), entry), entry);
+    }
+    last_use[v] = std::max(last_use[v], (uint)t + 1);
+  }
+  const auto g = path[t_end]->id;
+  rest_from[g] = std::min(rest_from[g], (uint)t_end);
+  T = std::max(T, (uint)t_end + 1);
+}
+
+uint ReservationTable::get_next(const uint t, const Vertex* v) const
+{
+  const auto& E = entries[v->id];
+  auto itr = std::lower_bound(E.begin(), E.end(), std::make_pair(t, 0u));
+  return (itr != E.end() && itr->first == t) ? itr->second : UINT_MAX;
+}
+
+bool ReservationTable::is_occupied(const uint t, const Vertex* v) const
+{
+  return t >= rest_from[v->id] || get_next(t, v) != UINT_MAX;
+}
+
+bool ReservationTable::is_valid_move(const uint t, const Vertex* from,
+                                     const Vertex* to) const
+{
+  if (is_occupied(t + 1, to)) return false;
+  // swap
+  return from == to || get_next(t, to) != from->id;
+}
+
+Config get_space_time_path(const Graph& G, const ReservationTable& RT,
+                           Vertex* s, Vertex* g, const Deadline* deadline)
+{
+  const auto V_size = G.size();
+  if (RT.rest_from[g->id] != UINT_MAX || RT.is_occupied(0, s)) return Config();
+
+  // heuristic, exact distances on the static map
+  auto h = std::vector<uint>(V_size, UINT_MAX);
+  auto Q = std::queue<Vertex*>();
+  h[g->id] = 0;
+  Q.push(g);
+  while (!Q.empty()) {
+    auto n = Q.front();
+    Q.pop();
+    for (auto m : n->in_neighbor) {
+      if (h[m->id] != UINT_MAX) continue;
+      h[m->id] = h[n->id] + 1;
+      Q.push(m);
+    }
+  }
+  if (h[s->id] == UINT_MAX) return Config();
+
+  // space-time A*; the map is static after all reservations end,
+  // so timesteps beyond RT.T share the same closed entries
+  struct Node {
+    Vertex* v;
+    uint t;
+    uint f;
+    int parent;
+  };
+  auto get_key = [&](const uint t, const Vertex* v) {
+    return (uint64_t)std::min(t, RT.T) * V_size + v->id;
+  };
+  // arrival no earlier than the last temporary use of the goal
+  auto get_f = [&](const uint t, const Vertex* v) {
+    return std::max(t + h[v->id], RT.last_use[g->id]);
+  };
+  auto nodes = std::vector<Node>();
+  auto cmp = [&](const int a, const int b) {
+    if (nodes[a].f != nodes[b].f) return nodes[a].f > nodes[b].f;
+    return nodes[a].t < nodes[b].t;  // deeper first
+  };
+  auto OPEN = std::priority_queue<int, std::vector<int>, decltype(cmp)>(cmp);
+  auto CLOSED = std::unordered_set<uint64_t>();
+  nodes.push_back({s, 0, get_f(0, s), -1});
+  OPEN.push(0);
+
+  while (!OPEN.empty() && !is_expired(deadline)) {
+    const auto k = OPEN.top();
+    OPEN.pop();
+    const auto n = nodes[k];  // copy, nodes may grow
+    if (!CLOSED.insert(get_key(n.t, n.v)).second) continue;
+
+    // stay at the goal forever
+    if (n.v == g && n.t >= RT.last_use[g->id]) {
+      auto path = Config(n.t + 1);
+      for (auto j = k; j >= 0; j = nodes[j].parent) {
+        path[nodes[j].t] = nodes[j].v;
+      }
+      return path;
+    }
+
+    auto expand = [&](Vertex* u) {
+      if (h[u->id] == UINT_MAX || !RT.is_valid_move(n.t, n.v, u)) return;
+      if (CLOSED.count(get_key(n.t + 1, u)) > 0) return;
+      nodes.push_back({u, n.t + 1, get_f(n.t + 1, u), k});
+      OPEN.push(nodes.size() - 1);
+    };
+    for (auto u : n.v->neighbor) expand(u);
+    expand(n.v);  // wait
+  }
+  return Config();
+}
+
+Solution replan(const Instance& ins, const Solution& solution,
+                const std::vector<uint>& agents, const Config& new_goals,
+                const Deadline* deadline, const int verbose)
+{
+  if (solution.empty() || agents.size() != new_goals.size()) return Solution();
+  const auto N = ins.N;
+  auto replanned = std::vector<bool>(N, false);
+  for (auto i : agents) replanned[i] = true;
+
+  // committed paths
+  auto RT_fixed = ReservationTable(ins.G.size());
+  auto paths = std::vector<Config>(N);
+  for (uint i = 0; i < N; ++i) {
+    if (replanned[i]) continue;
+    for (auto& C : solution) paths[i].push_back(C[i]);
+    RT_fixed.add(paths[i]);
+  }
+
+  // prioritized planning, in the given order;
+  // an agent that fails moves to the front and planning restarts
+  auto order = std::vector<size_t>(agents.size());
+  std::iota(order.begin(), order.end(), 0);
+  for (size_t attempt = 0; attempt < agents.size(); ++attempt) {
+    auto RT = RT_fixed;
+    auto failed = order.size();
+    for (size_t j = 0; j < order.size(); ++j) {
+      const auto k = order[j];
+      const auto i = agents[k];
+      paths[i] = get_space_time_path(ins.G, RT, solution[0][i], new_goals[k],
+                                     deadline);
+      if (paths[i].empty()) {
+        failed = j;
+        break;
+      }
+      RT.add(paths[i]);
+    }
+    if (failed == order.size()) break;
+    info(1, verbose, "failed to replan agent ", agents[order[failed]]);
+    if (failed == 0 || is_expired(deadline)) return Solution();
+    std::rotate(order.begin(), order.begin() + failed,
+                order.begin() + failed + 1);
+    if (attempt + 1 == agents.size()) return Solution();
+  }
+
+  // merge
+  size_t T = 0;
+  for (auto& path : paths) T = std::max(T, path.size());
+  auto merged = Solution(T, Config(N, nullptr));
+  for (size_t t = 0; t < T; ++t) {
+    for (uint i = 0; i < N; ++i) {
+      merged[t][i] = paths[i][std::min(t, paths[i].size() - 1)];
+    }
+  }
+  info(1, verbose, "replanned ", agents.size(), " agents, makespan: ", T - 1);
+  return merged;
+}
@@ -0,0 +1,145 @@
+#include "../include/shm_handoff.hpp"
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <ctime>
+
+// shared mappings, hence no FUTEX_PRIVATE_FLAG
+static long futex(std::atomic<uint32_t>* word, const int op, const uint32_t val,
+                  const timespec* timeout = nullptr)
+{
+  return syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), op, val,
+                 timeout, nullptr, 0);
+}
+
+ShmSegment::ShmSegment(const std::string& _name)
+    : name(_name), fd(-1), addr(nullptr), size(0), seen(0)
+{
+  fd = shm_open(name.c_str(), O_RDWR | O_CREAT, 0600);
+  if (fd < 0) {
+    info(0, 0, "failed to open shared memory ", name, ": ",
+         std::strerror(errno));
+    return;
+  }
+  if (!map(sizeof(ShmHeader))) {
+    close(fd);
+    fd = -1;
+  }
+}
+
+ShmSegment::~ShmSegment()
+{
+  if (addr != nullptr) munmap(addr, size);
+  if (fd >= 0) close(fd);
+}
+
+bool ShmSegment::is_open() const { return fd >= 0; }
+
+bool ShmSegment::map(const size_t _size)
+{
+  struct stat st;
+  if (fstat(fd, &st) != 0) return false;
+  // never shrink, the other side may have mapped more
+  if ((size_t)st.st_size < _size && ftruncate(fd, _size) != 0) return false;
+  auto new_addr = mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (new_addr == MAP_FAILED) return false;
+  if (addr != nullptr) munmap(addr, size);
+  addr = new_addr;
+  size = _size;
+  return true;
+}
+
+ShmHeader* ShmSegment::header() const
+{
+  return reinterpret_cast<ShmHeader*>(addr);
+}
+
+void ShmSegment::unlink() { shm_unlink(name.c_str()); }
+
+void ShmSegment::invalidate()
+{
+  if (!is_open()) return;
+  header()->state.store(SHM_EMPTY, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+}
+
+bool ShmSegment::publish(const Instance& ins, const Solution& solution,
+                         const double comp_time_ms)
+{
+  if (!is_open()) return false;
+  const auto T = solution.size();
+  const auto data_offset = (sizeof(ShmHeader) + 63) / 64 * 64;
+  const auto total = data_offset + T * ins.N * sizeof(uint32_t);
+  if (!map(total)) {
+    info(0, 0, "failed to map shared memory ", name);
+    return false;
+  }
+
+  // clients must not take a previous result while it is overwritten
+  invalidate();
+  auto h = header();
+
+  // data first, the state and the generation are released last
+  auto dst = reinterpret_cast<uint32_t*>((char*)addr + data_offset);
+  for (auto& C : solution) {
+    for (auto v : C) *(dst++) = v->index;
+  }
+  h->magic = ShmHeader::MAGIC;
+  h->N = ins.N;
+  h->T = T;
+  h->width = ins.G.width;
+  h->height = ins.G.height;
+  h->comp_time_ms = comp_time_ms;
+  h->data_offset = data_offset;
+  h->size = total;
+  h->state.store(solution.empty() ? SHM_FAILED : SHM_READY,
+                 std::memory_order_release);
+  h->generation.fetch_add(1, std::memory_order_release);
+  futex(&h->generation, FUTEX_WAKE, INT_MAX);
+  return true;
+}
+
+bool ShmSegment::wait(const int timeout_ms)
+{
+  if (!is_open()) return false;
+  const auto deadline = Deadline(timeout_ms);
+  while (true) {
+    const auto g = header()->generation.load(std::memory_order_acquire);
+    if (g != seen) {
+      seen = g;
+      if (header()->state.load(std::memory_order_acquire) != SHM_EMPTY) break;
+      continue;  // the next publish has already started, wait for it
+    }
+    timespec ts;
+    timespec* timeout = nullptr;
+    if (timeout_ms >= 0) {
+      const auto rest_ms = timeout_ms - deadline.elapsed_ms();
+      if (rest_ms <= 0) return false;
+      ts.tv_sec = (time_t)(rest_ms / 1000);
+      ts.tv_nsec = (long)((rest_ms - ts.tv_sec * 1000) * 1e6);
+      timeout = &ts;
+    }
+    // returns immediately when the generation has already changed
+    futex(&header()->generation, FUTEX_WAIT, g, timeout);
+  }
+  return map(header()->size);
+}
+
+const uint32_t* ShmSegment::data() const
+{
+  return reinterpret_cast<const uint32_t*>((char*)addr +
+                                           header()->data_offset);
+}
+
+uint32_t ShmSegment::get(const uint t, const uint i) const
+{
+  return data()[(size_t)t * header()->N + i];
+}
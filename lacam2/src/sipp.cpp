@@ -0,0 +1,127 @@
+#include "../include/sipp.hpp"
+
+SIPP::SIPP(const Graph& _G, const ReservationTable& _RT)
+    : G(_G),
+      RT(_RT),
+      offsets(G.size() + 1, 0),
+      intervals(),
+      g_best(),
+      stamps(),
+      stamp(0),
+      num_expanded(0)
+{
+  // gaps between occupied timesteps, until the agent resting there
+  for (uint v = 0; v < G.size(); ++v) {
+    offsets[v] = intervals.size();
+    uint begin = 0;
+    for (auto& entry : RT.entries[v]) {
+      if (entry.first > begin) intervals.emplace_back(begin, entry.first);
+      begin = entry.first + 1;
+    }
+    const auto rest_from = RT.rest_from[v];
+    if (rest_from == UINT_MAX) {
+      intervals.emplace_back(begin, UINT_MAX);
+    } else if (rest_from > begin) {
+      intervals.emplace_back(begin, rest_from);
+    }
+  }
+  offsets[G.size()] = intervals.size();
+  g_best.assign(intervals.size(), UINT_MAX);
+  stamps.assign(intervals.size(), 0);
+}
+
+Config SIPP::find_path(Vertex* s, DistTable& D, const uint i,
+                       const Deadline* deadline)
+{
+  const auto goal = D.goals[i];
+  if (++stamp == 0) {
+    std::fill(stamps.begin(), stamps.end(), 0);
+    stamp = 1;
+  }
+
+  // initial interval
+  const auto itr_begin = intervals.begin() + offsets[s->id];
+  const auto itr_end = intervals.begin() + offsets[s->id + 1];
+  if (itr_begin == itr_end || itr_begin->first != 0) return Config();
+  const uint k_init = offsets[s->id];
+
+  struct Node {
+    Vertex* v;
+    uint k;  // interval
+    uint t;  // arrival
+    uint f;
+    uint h;
+    int parent;
+  };
+  // arrival no earlier than the last interval of the goal
+  const auto goal_last = offsets[goal->id + 1];
+  if (goal_last == offsets[goal->id]) return Config();
+  if (intervals[goal_last - 1].second != UINT_MAX) return Config();
+  const auto goal_from = intervals[goal_last - 1].first;
+  auto get_f = [&](const uint t, const uint h) {
+    return std::max(t + h, goal_from);
+  };
+  auto nodes = std::vector<Node>();
+  auto cmp = [&](const int a, const int b) {
+    if (nodes[a].f != nodes[b].f) return nodes[a].f > nodes[b].f;
+    // closer to the goal first, e.g., while waiting for its last interval
+    if (nodes[a].h != nodes[b].h) return nodes[a].h > nodes[b].h;
+    return nodes[a].t < nodes[b].t;
+  };
+  auto OPEN = std::priority_queue<int, std::vector<int>, decltype(cmp)>(cmp);
+  const auto h_init = D.get(i, s);
+  nodes.push_back({s, k_init, 0, get_f(0, h_init), h_init, -1});
+  OPEN.push(0);
+  g_best[k_init] = 0;
+  stamps[k_init] = stamp;
+
+  while (!OPEN.empty() && !is_expired(deadline)) {
+    const auto j = OPEN.top();
+    OPEN.pop();
+    const auto n = nodes[j];  // copy, nodes may grow
+    if (g_best[n.k] < n.t) continue;  // outdated
+    ++num_expanded;
+
+    // the last interval of the goal is safe forever
+    if (n.v == goal && intervals[n.k].second == UINT_MAX) {
+      auto path = Config(n.t + 1);
+      for (auto c = j; c >= 0; c = nodes[c].parent) {
+        path[nodes[c].t] = nodes[c].v;
+        const auto p = nodes[c].parent;
+        if (p < 0) continue;
+        for (auto t = nodes[p].t + 1; t < nodes[c].t; ++t) {
+          path[t] = nodes[p].v;  // wait
+        }
+      }
+      return path;
+    }
+
+    // arrivals at t + 1 .. end, departing no later than end - 1
+    const auto end = intervals[n.k].second;
+    for (auto u : n.v->neighbor) {
+      const auto h = D.get(i, u);
+      if (h >= D.V_size) continue;  // unreachable
+      for (auto k = offsets[u->id]; k < offsets[u->id + 1]; ++k) {
+        const auto [b, e] = intervals[k];
+        if (e <= n.t + 1) continue;
+        if (b > end) break;
+        auto a = std::max(n.t + 1, b);
+        // swap with the agent leaving u toward v, only if u is occupied at a-1
+        if (a == b && RT.get_next(a - 1, u) == n.v->id) ++a;
+        if (a >= e || a > end) continue;
+        if (stamps[k] == stamp && g_best[k] <= a) continue;
+        stamps[k] = stamp;
+        g_best[k] = a;
+        nodes.push_back({u, k, a, get_f(a, h), h, j});
+        OPEN.push(nodes.size() - 1);
+      }
+    }
+  }
+  return Config();
+}
+
+size_t SIPP::memory_usage() const
+{
+  return offsets.size() * sizeof(uint) +
+         intervals.size() * sizeof(std::pair<uint, uint>);
+}
@@ -0,0 +1,186 @@
+#include "../include/solution_cache.hpp"
+
+#include <filesystem>
+#include <sstream>
+
+#include "../include/post_processing.hpp"
+
+// FNV-1a, 64bit
+static void hash_combine(uint64_t& hash, const uint64_t val)
+{
+  for (auto k = 0; k < 8; ++k) {
+    hash ^= (val >> (8 * k)) & 0xff;
+    hash *= 0x100000001b3;
+  }
+}
+
+uint64_t get_instance_hash(const Instance& ins, const Objective objective)
+{
+  uint64_t hash = 0xcbf29ce484222325;
+  hash_combine(hash, ins.G.width);
+  hash_combine(hash, ins.G.height);
+  // obstacles, packed into 64bit words
+  uint64_t word = 0;
+  for (size_t k = 0; k < ins.G.U.size(); ++k) {
+    if (ins.G.U[k] != nullptr) word |= (uint64_t)1 << (k % 64);
+    if (k % 64 == 63 || k + 1 == ins.G.U.size()) {
+      hash_combine(hash, word);
+      word = 0;
+    }
+  }
+  // one-way cells
+  if (ins.G.directed) {
+    for (auto v : ins.G.V) {
+      for (auto u : v->neighbor) hash_combine(hash, u->index);
+      hash_combine(hash, v->neighbor.size());
+    }
+  }
+  hash_combine(hash, ins.N);
+  for (auto v : ins.starts) hash_combine(hash, v->index);
+  for (auto v : ins.goals) hash_combine(hash, v->index);
+  hash_combine(hash, objective);
+  return hash;
+}
+
+static const uint64_t CACHE_FILE_MAGIC = 0x6c6163616d32636bULL;
+
+SolutionCache::SolutionCache(const size_t _capacity,
+                             const std::string& _cache_dir)
+    : capacity(_capacity), cache_dir(_cache_dir), hit_cnt(0), miss_cnt(0)
+{
+  if (!cache_dir.empty()) {
+    std::error_code ec;
+    std::filesystem::create_directories(cache_dir, ec);
+  }
+}
+
+static std::string get_cache_filename(const std::string& cache_dir,
+                                      const uint64_t key)
+{
+  std::stringstream ss;
+  ss << cache_dir << "/" << std::hex << std::setw(16) << std::setfill('0')
+     << key << ".sol";
+  return ss.str();
+}
+
+// binary format: magic, key, N, length of path, path
+static bool load_entry(const std::string& cache_dir, const uint64_t key,
+                       SolutionCache::Entry& entry)
+{
+  std::ifstream file(get_cache_filename(cache_dir, key), std::ios::binary);
+  if (!file) return false;
+  uint64_t magic = 0, size = 0;
+  file.read((char*)&magic, sizeof(magic));
+  file.read((char*)&entry.key, sizeof(entry.key));
+  file.read((char*)&entry.N, sizeof(entry.N));
+  file.read((char*)&size, sizeof(size));
+  if (!file || magic != CACHE_FILE_MAGIC || entry.key != key) return false;
+  entry.path.resize(size);
+  file.read((char*)entry.path.data(), sizeof(uint) * size);
+  return (bool)file;
+}
+
+static void save_entry(const std::string& cache_dir,
+                       const SolutionCache::Entry& entry)
+{
+  // write to a temporary file then rename, avoiding partial reads
+  const auto filename = get_cache_filename(cache_dir, entry.key);
+  const auto tmp_filename = filename + ".tmp";
+  std::ofstream file(tmp_filename, std::ios::binary);
+  if (!file) return;
+  const uint64_t size = entry.path.size();
+  file.write((const char*)&CACHE_FILE_MAGIC, sizeof(CACHE_FILE_MAGIC));
+  file.write((const char*)&entry.key, sizeof(entry.key));
+  file.write((const char*)&entry.N, sizeof(entry.N));
+  file.write((const char*)&size, sizeof(size));
+  file.write((const char*)entry.path.data(), sizeof(uint) * size);
+  file.close();
+  std::error_code ec;
+  std::filesystem::rename(tmp_filename, filename, ec);
+}
+
+bool SolutionCache::find(const Instance& ins, const Objective objective,
+                         Solution& solution, const int verbose)
+{
+  const auto key = get_instance_hash(ins, objective);
+  auto entry = Entry();
+  auto iter = table.find(key);
+  if (iter != table.end()) {
+    entry = std::move(*(iter->second));
+    entries.erase(iter->second);
+    table.erase(iter);
+  } else if (cache_dir.empty() || !load_entry(cache_dir, key, entry)) {
+    ++miss_cnt;
+    return false;
+  }
+
+  // restore configurations
+  auto sol = Solution();
+  const auto U_size = ins.G.U.size();
+  bool valid = (entry.N == ins.N && entry.N > 0 &&
+                entry.path.size() % entry.N == 0);
+  for (size_t k = 0; valid && k < entry.path.size(); k += entry.N) {
+    auto C = Config(entry.N, nullptr);
+    for (size_t i = 0; i < entry.N; ++i) {
+      const auto index = entry.path[k + i];
+      if (index >= U_size || ins.G.U[index] == nullptr) {
+        valid = false;
+        break;
+      }
+      C[i] = ins.G.U[index];
+    }
+    sol.push_back(C);
+  }
+
+  // validation, e.g., against hash collisions or broken files
+  if (!valid || sol.empty() || !is_feasible_solution(ins, sol)) {
+    info(1, verbose, "discard invalid cache entry");
+    if (!cache_dir.empty()) {
+      std::error_code ec;
+      std::filesystem::remove(get_cache_filename(cache_dir, key), ec);
+    }
+    ++miss_cnt;
+    return false;
+  }
+
+  touch(std::move(entry));
+  solution = std::move(sol);
+  ++hit_cnt;
+  return true;
+}
+
+void SolutionCache::insert(const Instance& ins, const Objective objective,
+                           const Solution& solution)
+{
+  if (solution.empty()) return;
+  auto entry = Entry();
+  entry.key = get_instance_hash(ins, objective);
+  entry.N = ins.N;
+  entry.path.reserve(solution.size() * ins.N);
+  for (auto& C : solution) {
+    for (auto v : C) entry.path.push_back(v->index);
+  }
+  erase(entry.key);
+  if (!cache_dir.empty()) save_entry(cache_dir, entry);
+  touch(std::move(entry));
+}
+
+void SolutionCache::erase(const uint64_t key)
+{
+  auto iter = table.find(key);
+  if (iter == table.end()) return;
+  entries.erase(iter->second);
+  table.erase(iter);
+}
+
+void SolutionCache::touch(Entry&& entry)
+{
+  if (capacity == 0) return;
+  const auto key = entry.key;
+  entries.push_front(std::move(entry));
+  table[key] = entries.begin();
+  while (entries.size() > capacity) {
+    table.erase(entries.back().key);
+    entries.pop_back();
+  }
+}
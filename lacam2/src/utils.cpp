@@ -1,9 +1,7 @@
 #include "../include/utils.hpp"
 
-void info(const int level, const int verbose) { std::cout << std::endl; }
-
 Deadline::Deadline(double _time_limit_ms)
-    : t_s(Time::now()), time_limit_ms(_time_limit_ms)
+    : t_s(Time::now()), time_limit_ms(_time_limit_ms), cancelled(false)
 {
 }
 
@@ -20,6 +18,8 @@ double Deadline::elapsed_ns() const
       .count();
 }
 
+void Deadline::cancel() const { cancelled = true; }
+
 double elapsed_ms(const Deadline* deadline)
 {
   if (deadline == nullptr) return 0;
@@ -35,7 +35,8 @@ double elapsed_ns(const Deadline* deadline)
 bool is_expired(const Deadline* deadline)
 {
   if (deadline == nullptr) return false;
-  return deadline->elapsed_ms() > deadline->time_limit_ms;
+  return deadline->cancelled.load(std::memory_order_relaxed) ||
+         deadline->elapsed_ms() > deadline->time_limit_ms;
 }
 
 float get_random_float(std::mt19937* MT, float from, float to)
@@ -49,3 +50,143 @@ int get_random_int(std::mt19937* MT, int from, int to)
   std::uniform_int_distribution<int> r(from, to);
   return r(*MT);
 }
+
+Histogram::Histogram(const size_t _max_bin) : bins(), max_bin(_max_bin) {}
+
+void Histogram::add(const size_t val)
+{
+  const auto k = std::min(val, max_bin);
+  if (k >= bins.size()) bins.resize(k + 1, 0);
+  ++bins[k];
+}
+
+void Histogram::merge(const Histogram& other)
+{
+  if (other.bins.size() > bins.size()) bins.resize(other.bins.size(), 0);
+  for (size_t k = 0; k < other.bins.size(); ++k) bins[k] += other.bins[k];
+}
+
+uint64_t Histogram::total() const
+{
+  return std::accumulate(bins.begin(), bins.end(), (uint64_t)0);
+}
+
+double Histogram::mean() const
+{
+  uint64_t sum = 0;
+  for (size_t k = 0; k < bins.size(); ++k) sum += k * bins[k];
+  const auto cnt = total();
+  return cnt == 0 ? 0 : (double)sum / cnt;
+}
+
+std::string Histogram::str() const
+{
+  auto s = std::string();
+  for (size_t k = 0; k < bins.size(); ++k) {
+    if (k > 0) s += ",";
+    s += std::to_string(bins[k]);
+  }
+  return s;
+}
+
+ThreadPool::ThreadPool(const size_t num_threads)
+    : job(nullptr),
+      num_jobs(0),
+      next_job(0),
+      num_finished(0),
+      generation(0),
+      each(false),
+      stop(false)
+{
+  for (size_t k = 1; k < num_threads; ++k) {
+    threads.emplace_back([this, k]() { work(k); });
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lk(mtx);
+    stop = true;
+  }
+  cv_start.notify_all();
+  for (auto& th : threads) th.join();
+}
+
+size_t ThreadPool::size() const { return threads.size() + 1; }
+
+void ThreadPool::run(const size_t n, const std::function<void(size_t)>& f)
+{
+  if (threads.empty() || n <= 1) {
+    for (size_t k = 0; k < n; ++k) f(k);
+    return;
+  }
+  dispatch(n, f, false);
+}
+
+void ThreadPool::run_each(const std::function<void(size_t)>& f)
+{
+  if (threads.empty()) {
+    f(0);
+    return;
+  }
+  dispatch(size(), f, true);
+}
+
+void ThreadPool::run_bound(const size_t n, const std::function<void(size_t)>& f)
+{
+  if (threads.empty() || n <= 1) {
+    for (size_t k = 0; k < n; ++k) f(k);
+    return;
+  }
+  const std::function<void(size_t)> g = [&](size_t k) {
+    if (k < n) f(k);
+  };
+  dispatch(size(), g, true);
+}
+
+void ThreadPool::dispatch(const size_t n, const std::function<void(size_t)>& f,
+                          const bool _each)
+{
+  {
+    std::lock_guard<std::mutex> lk(mtx);
+    job = &f;
+    num_jobs = n;
+    next_job = 0;
+    num_finished = 0;
+    each = _each;
+    ++generation;
+  }
+  cv_start.notify_all();
+  if (each) {
+    f(0);
+  } else {
+    for (auto k = next_job++; k < n; k = next_job++) f(k);
+  }
+  // every thread must leave the generation before the next call
+  std::unique_lock<std::mutex> lk(mtx);
+  cv_done.wait(lk, [&]() { return num_finished == threads.size(); });
+}
+
+void ThreadPool::work(const size_t worker_id)
+{
+  uint seen = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lk(mtx);
+      cv_start.wait(lk, [&]() { return stop || generation != seen; });
+      if (stop) return;
+      seen = generation;
+    }
+    if (each) {
+      (*job)(worker_id);
+    } else {
+      for (auto k = next_job++; k < num_jobs; k = next_job++) (*job)(k);
+    }
+    {
+      std::lock_guard<std::mutex> lk(mtx);
+      ++num_finished;
+    }
+    cv_done.notify_one();
+  }
+}
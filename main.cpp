@@ -1,6 +1,55 @@
 #include <argparse/argparse.hpp>
 #include <lacam2.hpp>
 
+// one CSV row per N, map and distance table rows are shared across N
+// no solution cache, every run is measured
+static int sweep(const Instance& ins, const uint step, const uint runs,
+                 const int verbose, const int time_limit_sec, const int seed,
+                 const Objective objective, const float restart_rate,
+                 const std::string& output_name, const PlannerOptions& options)
+{
+  std::ofstream log(output_name, std::ios::out);
+  log << "agents,runs,solved,success_rate,dist_setup_ms,reused_rows,"
+         "mean_comp_time_ms,max_comp_time_ms,mean_soc\n";
+  auto D = DistTable(Instance(ins, 0), options.dist);
+  for (uint n = step; n < ins.N + step; n += step) {
+    n = std::min(n, ins.N);
+    const auto ins_n = Instance(ins, n);
+    if (!ins_n.is_valid(1)) return 1;
+    const auto reused_rows = std::min((size_t)n, D.goals.size());
+    const auto t_setup = Deadline();
+    D.extend(&ins_n);
+    const auto setup_ms = t_setup.elapsed_ns() / 1e6;
+
+    uint solved = 0;
+    double sum_comp_time_ms = 0, max_comp_time_ms = 0, sum_soc = 0;
+    for (uint r = 0; r < runs; ++r) {
+      auto MT = std::mt19937(seed + r);
+      auto additional_info = std::string("");
+      const auto deadline = Deadline(time_limit_sec * 1000);
+      const auto solution =
+          solve(ins_n, additional_info, verbose - 1, &deadline, &MT, objective,
+                restart_rate, nullptr, nullptr, &D, options);
+      const auto comp_time_ms = deadline.elapsed_ms();
+      uint offgoals = 0, badmoves = 0;
+      if (!solution.empty() &&
+          is_feasible_solution(offgoals, badmoves, ins_n, solution, verbose)) {
+        ++solved;
+        sum_soc += get_sum_of_costs(solution);
+      }
+      sum_comp_time_ms += comp_time_ms;
+      max_comp_time_ms = std::max(max_comp_time_ms, comp_time_ms);
+    }
+    log << n << "," << runs << "," << solved << "," << (double)solved / runs
+        << "," << setup_ms << "," << reused_rows << ","
+        << sum_comp_time_ms / runs << "," << max_comp_time_ms << ","
+        << (solved > 0 ? sum_soc / solved : -1) << std::endl;
+    info(1, verbose, "N=", n, "\tsolved: ", solved, "/", runs,
+         "\tdist setup: ", setup_ms, "ms");
+  }
+  return 0;
+}
+
 int main(int argc, char* argv[])
 {
   // arguments parser
@@ -33,9 +82,135 @@ int main(int argc, char* argv[])
         if (std::find(C.begin(), C.end(), value) != C.end()) return value;
         return std::string("0");
       });
+  program.add_argument("--refine")
+      .help("with an objective, refine the solution until the time limit")
+      .default_value(false)
+      .implicit_value(true);
   program.add_argument("-r", "--restart_rate")
       .help("restart rate")
       .default_value(std::string("0.001"));
+  program.add_argument("--successor_order")
+      .help("low-level successor order, 0: random, 1: distance to goal")
+      .default_value(std::string("0"))
+      .action([](const std::string& value) {
+        static const std::vector<std::string> C = {"0", "1"};
+        if (std::find(C.begin(), C.end(), value) != C.end()) return value;
+        return std::string("0");
+      });
+  program.add_argument("--threads")
+      .help("experimental, number of threads for batched low-level "
+            "expansion; scaling not measured yet, see "
+            "bench_parallel_expansion")
+      .default_value(std::string("1"));
+  program.add_argument("--gc_interval")
+      .help("interval (iterations) to free dominated nodes during --refine, "
+            "0: disabled")
+      .default_value(std::string("10000"));
+  program.add_argument("--cold_dir")
+      .help("directory to spill explored configurations, empty: in-memory")
+      .default_value(std::string(""));
+  program.add_argument("--hot_capacity")
+      .help("max number of explored configurations kept in memory")
+      .default_value(std::string("1000000"));
+  program.add_argument("--huge_pages")
+      .help("back large arrays with 2MB huge pages")
+      .default_value(false)
+      .implicit_value(true);
+  program.add_argument("--numa")
+      .help("node-local distance table rows and worker threads")
+      .default_value(false)
+      .implicit_value(true);
+  program.add_argument("--perf")
+      .help("hardware counters per planner phase, if available")
+      .default_value(false)
+      .implicit_value(true);
+  program.add_argument("--pibt_stats")
+      .help("histograms of PIBT inheritance and failures")
+      .default_value(false)
+      .implicit_value(true);
+  program.add_argument("--heatmap")
+      .help("per-vertex congestion metrics, *.bin -> binary, otherwise CSV")
+      .default_value(std::string(""));
+  program.add_argument("--dist")
+      .help("distance table, 0: lazy BFS, 1: landmarks, 2: bounded BFS")
+      .default_value(std::string("0"))
+      .action([](const std::string& value) {
+        static const std::vector<std::string> C = {"0", "1", "2"};
+        if (std::find(C.begin(), C.end(), value) != C.end()) return value;
+        return std::string("0");
+      });
+  program.add_argument("--landmarks")
+      .help("number of landmarks")
+      .default_value(std::string("16"));
+  program.add_argument("--landmark_selection")
+      .help("0: random, 1: farthest")
+      .default_value(std::string("1"))
+      .action([](const std::string& value) {
+        static const std::vector<std::string> C = {"0", "1"};
+        if (std::find(C.begin(), C.end(), value) != C.end()) return value;
+        return std::string("1");
+      });
+  program.add_argument("--landmark_radius")
+      .help("exact distances within this radius of goals")
+      .default_value(std::string("8"));
+  program.add_argument("--bfs_radius")
+      .help("bounded BFS, free expansions within this radius of goals")
+      .default_value(std::string("0"));
+  program.add_argument("--bfs_budget")
+      .help("bounded BFS, expansions per query beyond the radius")
+      .default_value(std::string("64"));
+  program.add_argument("--sweep_step")
+      .help(
+          "sweep N = step, 2 * step, ..., num over scenario prefixes, 0: off; "
+          "without solution cache")
+      .default_value(std::string("0"));
+  program.add_argument("--sweep_runs")
+      .help("runs per N in the sweep, with seeds seed, seed + 1, ...")
+      .default_value(std::string("1"));
+  program.add_argument("--shm")
+      .help("also hand the solution over via POSIX shared memory, e.g., /name")
+      .default_value(std::string(""));
+  program.add_argument("--prev")
+      .help("previous result file, to output per-agent path changes")
+      .default_value(std::string(""));
+  program.add_argument("--diff_output")
+      .help("output file of path changes against --prev")
+      .default_value(std::string("./build/diff.txt"));
+  program.add_argument("--portfolio")
+      .help("number of configurations solved by worker processes, 0: off")
+      .default_value(std::string("0"));
+  program.add_argument("--portfolio_local")
+      .help("number of local worker processes, -1: --portfolio")
+      .default_value(std::string("-1"));
+  program.add_argument("--portfolio_port")
+      .help("coordinator port on localhost, 0: any free port")
+      .default_value(std::string("0"));
+  program.add_argument("--portfolio_mode")
+      .help("0: first solution, 1: best solution until the time limit")
+      .default_value(std::string("0"));
+  program.add_argument("--worker")
+      .help("run as a portfolio worker of the coordinator at host:port")
+      .default_value(std::string(""));
+  program.add_argument("--differential")
+      .help("compare optimized code paths with references on random instances "
+            "with up to --num agents, 0: off")
+      .default_value(std::string("0"));
+  program.add_argument("--log_async")
+      .help("write logs from a background thread")
+      .default_value(false)
+      .implicit_value(true);
+  program.add_argument("--log_file")
+      .help("also write logs to this file")
+      .default_value(std::string(""));
+  program.add_argument("--json")
+      .help("also write the log as a JSON object to this file")
+      .default_value(std::string(""));
+  program.add_argument("--jsonl")
+      .help("append the log as a JSON line to this file, for batch runs")
+      .default_value(std::string(""));
+  program.add_argument("-c", "--cache_dir")
+      .help("directory of solution cache, empty -> no cache")
+      .default_value(std::string(""));
 
   try {
     program.parse_known_args(argc, argv);
@@ -45,6 +220,13 @@ int main(int argc, char* argv[])
     std::exit(1);
   }
 
+  // logging
+  const auto log_file = program.get<std::string>("log_file");
+  if (!log_file.empty() && !Logger::add_file_sink(log_file)) {
+    info(0, 0, "failed to open ", log_file);
+  }
+  if (program.get<bool>("log_async")) Logger::start();
+
   // setup instance
   const auto verbose = std::stoi(program.get<std::string>("verbose"));
   const auto time_limit_sec =
@@ -56,34 +238,153 @@ int main(int argc, char* argv[])
   const auto output_name = program.get<std::string>("output");
   const auto log_short = program.get<bool>("log_short");
   const auto N = std::stoi(program.get<std::string>("num"));
+  const auto t_load = Deadline();
   const auto ins = scen_name.size() > 0 ? Instance(scen_name, map_name, N)
                                         : Instance(map_name, &MT, N);
+  const auto load_ms = t_load.elapsed_ns() / 1e6;
   const auto objective =
       static_cast<Objective>(std::stoi(program.get<std::string>("objective")));
   const auto restart_rate = std::stof(program.get<std::string>("restart_rate"));
+  const auto cache_dir = program.get<std::string>("cache_dir");
+  auto options = PlannerOptions();
+  options.refine = program.get<bool>("refine");
+  options.successor_order = static_cast<SuccessorOrder>(
+      std::stoi(program.get<std::string>("successor_order")));
+  options.num_threads = std::stoi(program.get<std::string>("threads"));
+  options.gc_interval = std::stoi(program.get<std::string>("gc_interval"));
+  options.cold_dir = program.get<std::string>("cold_dir");
+  options.hot_capacity = std::stoul(program.get<std::string>("hot_capacity"));
+  options.numa = program.get<bool>("numa");
+  options.huge_pages = program.get<bool>("huge_pages");
+  options.perf = program.get<bool>("perf");
+  options.pibt_stats = program.get<bool>("pibt_stats");
+  options.dist.mode =
+      static_cast<DistMode>(std::stoi(program.get<std::string>("dist")));
+  options.dist.num_landmarks =
+      std::stoi(program.get<std::string>("landmarks"));
+  options.dist.landmark_selection = static_cast<LandmarkSelection>(
+      std::stoi(program.get<std::string>("landmark_selection")));
+  options.dist.landmark_radius =
+      std::stoi(program.get<std::string>("landmark_radius"));
+  options.dist.bfs_radius = std::stoi(program.get<std::string>("bfs_radius"));
+  options.dist.bfs_budget = std::stoi(program.get<std::string>("bfs_budget"));
+  options.dist.numa = options.numa;
+  options.dist.huge_pages = options.huge_pages;
+  const auto sweep_step = std::stoi(program.get<std::string>("sweep_step"));
+  if (sweep_step > 0) {
+    // cached solutions would hide the success rate and the runtime
+    if (!cache_dir.empty()) {
+      info(0, 0, "--cache_dir cannot be used with --sweep_step");
+      return 1;
+    }
+    return sweep(ins, sweep_step,
+                 std::stoi(program.get<std::string>("sweep_runs")), verbose,
+                 time_limit_sec, seed, objective, restart_rate, output_name,
+                 options);
+  }
   if (!ins.is_valid(1)) return 1;
+  const auto num_differential =
+      std::stoi(program.get<std::string>("differential"));
+  if (num_differential > 0) {
+    const auto num_divergences =
+        run_differential(map_name, num_differential, N, seed, verbose);
+    info(1, verbose, "divergences: ", num_divergences);
+    return num_divergences == 0 ? 0 : 1;
+  }
+  const auto worker = program.get<std::string>("worker");
+  if (!worker.empty()) {
+    const auto colon = worker.rfind(':');
+    return portfolio_worker(ins, worker.substr(0, colon),
+                            std::stoi(worker.substr(colon + 1)), verbose,
+                            options);
+  }
+
+  // a result of an earlier run under the same name is outdated from now on
+  const auto shm_name = program.get<std::string>("shm");
+  auto shm = shm_name.empty() ? nullptr : new ShmSegment(shm_name);
+  if (shm != nullptr) shm->invalidate();
 
   // solve
   auto additional_info = std::string("");
   const auto deadline = Deadline(time_limit_sec * 1000);
-  const auto solution = solve(ins, additional_info, verbose - 1, &deadline, &MT,
-                              objective, restart_rate);
+  auto cache = SolutionCache(1, cache_dir);
+  const auto heatmap_name = program.get<std::string>("heatmap");
+  auto heatmap = Heatmap(ins.G);
+  const auto num_configs = std::stoi(program.get<std::string>("portfolio"));
+  auto configs = std::vector<PortfolioConfig>();
+  const float restart_rates[] = {restart_rate, 0, 0.01, 0.1};
+  for (auto k = 0; k < num_configs; ++k) {
+    configs.push_back({seed + k, restart_rates[k % 4], objective});
+  }
+  auto portfolio = Portfolio(
+      ins, configs,
+      static_cast<PortfolioMode>(
+          std::stoi(program.get<std::string>("portfolio_mode"))),
+      std::stoi(program.get<std::string>("portfolio_port")), verbose,
+      options);
+  const auto num_local = std::stoi(program.get<std::string>("portfolio_local"));
+  const auto solution =
+      num_configs > 0
+          ? portfolio.coordinate(&deadline,
+                                 num_local < 0 ? num_configs : num_local,
+                                 additional_info)
+          : solve(ins, additional_info, verbose - 1, &deadline, &MT, objective,
+                  restart_rate, cache_dir.empty() ? nullptr : &cache,
+                  heatmap_name.empty() ? nullptr : &heatmap, nullptr, options);
   const auto comp_time_ms = deadline.elapsed_ms();
 
   // failure
   if (solution.empty()) info(1, verbose, "failed to solve");
 
+  // handoff first, the client need not wait for logging
+  if (shm != nullptr) {
+    if (!shm->publish(ins, solution, comp_time_ms)) {
+      info(0, verbose, "failed to publish ", shm_name);
+    }
+    delete shm;
+  }
+
   // check feasibility
+  const auto t_check = Deadline();
   uint offgoals = 0, badmoves = 0;
   if (!is_feasible_solution(offgoals, badmoves, ins, solution, verbose)) {
-    std::cout << "invalid!" << std::endl;
+    info(0, 0, "invalid!");
     info(0, verbose, "invalid solution");
   }
 //  std::cout << "offgoals:\t" << offgoals << std::endl;
 //  std::cout << "badmoves:\t" << badmoves << std::endl;
+  const auto check_ms = t_check.elapsed_ns() / 1e6;
+
   // post processing
   print_stats(verbose, ins, solution, comp_time_ms);
-  make_log(ins, solution, output_name, comp_time_ms, map_name, seed,
-           additional_info, log_short);
+  const auto t_log = Deadline();
+  const auto stats = get_log_stats(ins, solution, comp_time_ms, map_name, seed,
+                                   additional_info);
+  make_log(ins, solution, output_name, stats, log_short);
+  const auto json_name = program.get<std::string>("json");
+  const auto jsonl_name = program.get<std::string>("jsonl");
+  if (!json_name.empty() || !jsonl_name.empty()) {
+    const auto timings = std::vector<std::pair<std::string, double> >(
+        {{"load_ms", load_ms},
+         {"solve_ms", comp_time_ms},
+         {"check_ms", check_ms},
+         {"log_ms", t_log.elapsed_ns() / 1e6}});
+    if (!json_name.empty()) {
+      make_json_log(ins, solution, json_name, stats, timings, log_short);
+    }
+    if (!jsonl_name.empty()) {
+      make_json_log(ins, solution, jsonl_name, stats, timings, log_short, true);
+    }
+  }
+  const auto prev_name = program.get<std::string>("prev");
+  if (!prev_name.empty()) {
+    const auto diff =
+        get_solution_diff(load_solution(ins, prev_name), solution);
+    make_diff_log(ins, diff, program.get<std::string>("diff_output"));
+    info(1, verbose, "changed agents: ", diff.paths.size(), "/", ins.N);
+  }
+  if (!heatmap_name.empty() && !heatmap.write(heatmap_name)) {
+    info(0, verbose, "failed to write ", heatmap_name);
+  }
   return 0;
 }
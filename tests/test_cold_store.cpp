@@ -0,0 +1,112 @@
+#include <lacam2.hpp>
+
+#include <filesystem>
+
+#include "gtest/gtest.h"
+
+TEST(ColdStore, spill_and_find)
+{
+  const auto dir =
+      (std::filesystem::temp_directory_path() / "lacam2_test_cold").string();
+  const auto G = Graph("./assets/random-32-32-10.map");
+  auto MT = std::mt19937(0);
+  const uint N = 5;
+  auto Cs = std::vector<Config>();
+  for (auto k = 0; k < 1000; ++k) {
+    auto C = Config();
+    for (uint i = 0; i < N; ++i) {
+      C.push_back(G.V[get_random_int(&MT, 0, G.V.size() - 1)]);
+    }
+    Cs.push_back(C);
+  }
+
+  {
+    auto cold = ColdStore(dir, G.V, N);
+    // two runs
+    for (size_t r = 0; r < 2; ++r) {
+      auto entries = std::vector<std::pair<uint64_t, const Config*> >();
+      for (size_t k = r * 500; k < (r + 1) * 500; ++k) {
+        entries.emplace_back(k, &Cs[k]);
+      }
+      cold.spill(entries);
+    }
+    ASSERT_EQ(cold.num_spilled, 1000);
+    // runs of the same size are merged
+    ASSERT_EQ(cold.runs.size(), 1);
+    ASSERT_EQ(cold.num_merges, 1);
+    ASSERT_EQ(cold.runs[0]->num_records, 1000);
+
+    uint64_t id;
+    auto C = Config();
+    for (size_t k = 0; k < Cs.size(); ++k) {
+      ASSERT_TRUE(cold.find(Cs[k], id));
+      ASSERT_TRUE(is_same_config(Cs[id], Cs[k]));
+      ASSERT_TRUE(cold.read(k, C));
+      ASSERT_TRUE(is_same_config(C, Cs[k]));
+    }
+    const auto C_unknown = Config(N, G.V[0]);
+    ASSERT_FALSE(cold.find(C_unknown, id));
+    ASSERT_FALSE(cold.read(1000, C));
+
+    // short reads are failures, C is not restored from a truncated run
+    std::filesystem::resize_file(cold.runs[0]->filename, 0);
+    ASSERT_FALSE(cold.read(0, C));
+  }
+  // run files are removed
+  ASSERT_TRUE(std::filesystem::is_empty(dir));
+  std::filesystem::remove_all(dir);
+}
+
+TEST(ColdStore, merge)
+{
+  const auto dir =
+      (std::filesystem::temp_directory_path() / "lacam2_test_cold_merge")
+          .string();
+  const auto G = Graph("./assets/random-32-32-10.map");
+  auto MT = std::mt19937(0);
+  const uint N = 5;
+  auto Cs = std::vector<Config>();
+  for (auto k = 0; k < 64000; ++k) {
+    auto C = Config();
+    for (uint i = 0; i < N; ++i) {
+      C.push_back(G.V[get_random_int(&MT, 0, G.V.size() - 1)]);
+    }
+    Cs.push_back(C);
+  }
+
+  {
+    auto cold = ColdStore(dir, G.V, N);
+    // beyond the I/O buffer of merges
+    for (size_t r = 0; r < 64; ++r) {
+      auto entries = std::vector<std::pair<uint64_t, const Config*> >();
+      for (size_t k = r * 1000; k < (r + 1) * 1000; ++k) {
+        entries.emplace_back(k, &Cs[k]);
+      }
+      ASSERT_TRUE(cold.spill(entries));
+      ASSERT_LE(cold.runs.size(), 7);
+    }
+    ASSERT_EQ(cold.runs.size(), 1);
+    ASSERT_EQ(cold.num_merges, 63);
+
+    // spilled again after a load, kept once by merges
+    auto entries = std::vector<std::pair<uint64_t, const Config*> >();
+    for (size_t k = 0; k < 64000; k += 2) entries.emplace_back(k, &Cs[k]);
+    ASSERT_TRUE(cold.spill(entries));
+    entries.clear();
+    for (size_t k = 1; k < 64000; k += 2) entries.emplace_back(k, &Cs[k]);
+    ASSERT_TRUE(cold.spill(entries));
+    ASSERT_EQ(cold.runs.size(), 1);
+    ASSERT_EQ(cold.runs[0]->num_records, 64000);
+
+    uint64_t id;
+    auto C = Config();
+    for (size_t k = 0; k < Cs.size(); ++k) {
+      ASSERT_TRUE(cold.find(Cs[k], id));
+      ASSERT_TRUE(is_same_config(Cs[id], Cs[k]));
+      ASSERT_TRUE(cold.read(k, C));
+      ASSERT_TRUE(is_same_config(C, Cs[k]));
+    }
+  }
+  ASSERT_TRUE(std::filesystem::is_empty(dir));
+  std::filesystem::remove_all(dir);
+}
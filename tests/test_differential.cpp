@@ -0,0 +1,72 @@
+#include <lacam2.hpp>
+
+#include "gtest/gtest.h"
+
+TEST(Differential, reference_distances)
+{
+  const auto scen_filename = "./assets/random-32-32-10-random-1.scen";
+  const auto map_filename = "./assets/random-32-32-10.map";
+  const auto ins = Instance(scen_filename, map_filename, 3);
+  const auto dist = get_reference_distances(ins.G, ins.goals[0]);
+  ASSERT_EQ(dist[ins.goals[0]->id], 0);
+  ASSERT_EQ(dist[ins.starts[0]->id], 16);
+}
+
+TEST(Differential, reference_pibt)
+{
+  // agent 0 at (0, 0) heading east, agent 1 at (1, 0) heading west
+  const auto ins = Instance("./assets/empty-8-8.map",
+                            std::vector<uint>({0, 1}),
+                            std::vector<uint>({2, 0}));
+  auto MT = std::mt19937(0);
+  auto pibt = ReferencePIBT(&ins, &MT);
+  ASSERT_TRUE(pibt.get_new_config(ins.starts, {0, 1}, {}));
+  ASSERT_NE(pibt.C_next[0], pibt.C_next[1]);
+  ASSERT_EQ(pibt.C_next[0], ins.G.U[1]);  // pushing agent 1 away
+
+  // vertex and swap conflicts among constraints
+  ASSERT_FALSE(pibt.get_new_config(ins.starts, {0, 1},
+                                   {{0, ins.G.U[8]}, {1, ins.G.U[8]}}));
+  ASSERT_FALSE(pibt.get_new_config(ins.starts, {0, 1},
+                                   {{0, ins.G.U[1]}, {1, ins.G.U[0]}}));
+}
+
+TEST(Differential, random_instances)
+{
+  // set LACAM_DIFF_INSTANCES for longer runs
+  const auto env = std::getenv("LACAM_DIFF_INSTANCES");
+  const uint num_instances = env == nullptr ? 300 : std::stoi(env);
+  ASSERT_EQ(run_differential("./assets/random-32-32-10.map", num_instances, 30),
+            0);
+  ASSERT_EQ(run_differential("./assets/loop-oneway.map", 20, 2), 0);
+}
+
+TEST(Differential, minimize)
+{
+  // no divergence, nothing to report
+  const auto map_filename = "./assets/random-32-32-10.map";
+  auto MT = std::mt19937(0);
+  const auto ins = Instance(map_filename, &MT, 10);
+  ASSERT_EQ(minimize_divergence(map_filename, ins, 0), "");
+}
+
+TEST(Differential, minimize_divergent)
+{
+  // a broken code path, diverging whenever agent 3 is present
+  const auto map_filename = "./assets/random-32-32-10.map";
+  auto MT = std::mt19937(0);
+  const auto ins = Instance(map_filename, &MT, 10);
+  const auto start = ins.starts[3];
+  auto broken = [&](const Instance& sub, const int) {
+    for (auto v : sub.starts) {
+      if (v->index == start->index) return std::string("broken: agent 3");
+    }
+    return std::string();
+  };
+  const auto res = minimize_divergence(map_filename, ins, 0, 200, broken);
+  ASSERT_NE(res.find("divergence: broken: agent 3"), std::string::npos);
+  const auto reproducer = std::string("Instance(\"") + map_filename + "\", {" +
+                          std::to_string(start->index) + "}, {" +
+                          std::to_string(ins.goals[3]->index) + "})";
+  ASSERT_NE(res.find(reproducer), std::string::npos);
+}
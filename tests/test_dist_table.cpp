@@ -1,3 +1,5 @@
+#include <sched.h>
+
 #include <lacam2.hpp>
 
 #include "gtest/gtest.h"
@@ -12,3 +14,150 @@ TEST(dist_table, init)
   ASSERT_EQ(dist_table.get(0, ins.goals[0]), 0);
   ASSERT_EQ(dist_table.get(0, ins.starts[0]), 16);
 }
+
+TEST(dist_table, setup_all)
+{
+  const auto scen_filename = "./assets/random-32-32-10-random-1.scen";
+  const auto map_filename = "./assets/random-32-32-10.map";
+  const auto ins = Instance(scen_filename, map_filename, 20);
+  auto lazy = DistTable(ins);
+  auto pool = ThreadPool(4);
+  for (auto numa : {false, true}) {
+    auto options = DistOptions();
+    options.numa = numa;
+    auto full = DistTable(ins, options);
+    full.setup_all(&pool);
+    for (uint i = 0; i < ins.N; ++i) {
+      for (auto v : ins.G.V) ASSERT_EQ(full.table[i * full.V_size + v->id],
+                                       lazy.get(i, v));
+    }
+  }
+
+  // the caller runs worker 0, its affinity is restored
+  cpu_set_t before, after;
+  ASSERT_EQ(sched_getaffinity(0, sizeof(before), &before), 0);
+  Numa::pin_pool(&pool);
+  Numa::unpin_caller();
+  ASSERT_EQ(sched_getaffinity(0, sizeof(after), &after), 0);
+  ASSERT_TRUE(CPU_EQUAL(&before, &after));
+
+  // bound jobs run on their workers
+  auto ids = std::vector<std::thread::id>(pool.size());
+  pool.run_each([&](size_t k) { ids[k] = std::this_thread::get_id(); });
+  auto ids_bound = std::vector<std::thread::id>(pool.size());
+  pool.run_bound(3, [&](size_t k) {
+    ids_bound[k] = std::this_thread::get_id();
+  });
+  for (size_t k = 0; k < 3; ++k) ASSERT_EQ(ids_bound[k], ids[k]);
+  ASSERT_EQ(ids_bound[3], std::thread::id());
+}
+
+TEST(dist_table, one_way)
+{
+  // clockwise loop, agent 0 is next to its goal against the lane
+  const auto ins = Instance("./assets/loop-oneway.map",
+                            std::vector<uint>({1}), std::vector<uint>({0}));
+  auto dist_table = DistTable(ins);
+  ASSERT_EQ(dist_table.get(0, ins.G.U[1]), 11);
+  ASSERT_EQ(dist_table.get(0, ins.G.U[5]), 1);
+}
+
+TEST(dist_table, landmarks)
+{
+  const auto scen_filename = "./assets/random-32-32-10-random-1.scen";
+  const auto map_filename = "./assets/random-32-32-10.map";
+  const auto ins = Instance(scen_filename, map_filename, 20);
+  auto exact = DistTable(ins);
+
+  auto options = DistOptions();
+  options.mode = DIST_LANDMARK;
+  options.num_landmarks = 4;
+  for (auto selection : {LANDMARK_RANDOM, LANDMARK_FARTHEST}) {
+    options.landmark_selection = selection;
+    auto lb = DistTable(ins, options);
+    ASSERT_LT(lb.memory_usage(), exact.memory_usage());
+    for (uint i = 0; i < ins.N; ++i) {
+      for (auto v : ins.G.V) {
+        const auto d = exact.get(i, v);
+        // admissible, exact around goals
+        ASSERT_LE(lb.get(i, v), d);
+        if (d <= options.landmark_radius) {
+          ASSERT_EQ(lb.get(i, v), d);
+        }
+      }
+    }
+  }
+
+  // one-way loop, against the lane
+  const auto ins_oneway = Instance("./assets/loop-oneway.map",
+                                   std::vector<uint>({1}),
+                                   std::vector<uint>({0}));
+  options.landmark_radius = 2;
+  auto lb = DistTable(ins_oneway, options);
+  ASSERT_LE(lb.get(0, ins_oneway.G.U[1]), 11);
+  ASSERT_GT(lb.get(0, ins_oneway.G.U[1]), 2);
+
+  // no landmark is chosen twice
+  options.num_landmarks = 16;
+  for (auto selection : {LANDMARK_RANDOM, LANDMARK_FARTHEST}) {
+    options.landmark_selection = selection;
+    auto lb = DistTable(ins, options);
+    auto ids = std::set<uint>();
+    for (auto v : lb.landmarks.vertices) ids.insert(v->id);
+    ASSERT_EQ(ids.size(), 16);
+  }
+}
+
+TEST(dist_table, bounded)
+{
+  const auto scen_filename = "./assets/random-32-32-10-random-1.scen";
+  const auto map_filename = "./assets/random-32-32-10.map";
+  const auto ins = Instance(scen_filename, map_filename, 20);
+  auto exact = DistTable(ins);
+
+  auto options = DistOptions();
+  options.mode = DIST_BOUNDED;
+  options.bfs_radius = 4;
+  options.bfs_budget = 8;
+  auto lb = DistTable(ins, options);
+  for (uint i = 0; i < ins.N; ++i) {
+    for (auto v : ins.G.V) {
+      const auto d = exact.get(i, v);
+      ASSERT_LE(lb.get(i, v), d);  // admissible
+      if (d <= options.bfs_radius) {
+        ASSERT_EQ(lb.get(i, v), d);
+      }
+    }
+  }
+  ASSERT_GT(lb.num_lower_bounds, 0);
+
+  // repeated queries extend the frontier until exact
+  for (uint i = 0; i < ins.N; ++i) {
+    for (auto v : ins.G.V) {
+      const auto d = exact.get(i, v);
+      for (uint k = 0; k < lb.V_size && lb.get(i, v) < d; ++k) continue;
+      ASSERT_EQ(lb.get(i, v), d);
+    }
+  }
+}
+
+TEST(dist_table, extend)
+{
+  const auto scen_filename = "./assets/random-32-32-10-random-1.scen";
+  const auto map_filename = "./assets/random-32-32-10.map";
+  const auto ins = Instance(scen_filename, map_filename, 20);
+  auto exact = DistTable(ins);
+
+  const auto ins_small = Instance(ins, 5);
+  auto dist_table = DistTable(ins_small);
+  ASSERT_EQ(dist_table.get(0, ins.starts[0]), 16);
+  dist_table.extend(&ins);
+  ASSERT_EQ(dist_table.goals.size(), ins.N);
+  for (uint i = 0; i < ins.N; ++i) {
+    for (auto v : ins.G.V) ASSERT_EQ(dist_table.get(i, v), exact.get(i, v));
+  }
+  // shrinking keeps the prefix
+  dist_table.extend(&ins_small);
+  ASSERT_EQ(dist_table.goals.size(), ins_small.N);
+  ASSERT_EQ(dist_table.get(0, ins.starts[0]), 16);
+}
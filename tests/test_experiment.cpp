@@ -0,0 +1,62 @@
+#include <lacam2.hpp>
+
+#include <filesystem>
+
+#include "gtest/gtest.h"
+
+TEST(Experiment, find_tasks)
+{
+  auto exp = Experiment(50, 0, 1000);
+  ASSERT_EQ(exp.find_tasks("./assets"), 3);
+  for (auto& [map_filename, scen_filename] : exp.tasks) {
+    const auto map_name = std::filesystem::path(map_filename).stem().string();
+    const auto scen_name = std::filesystem::path(scen_filename).stem().string();
+    ASSERT_EQ(scen_name.rfind(map_name, 0), 0);
+  }
+  ASSERT_EQ(exp.find_tasks("./no_such_dir"), 0);
+}
+
+TEST(Experiment, run)
+{
+  auto exp = Experiment(1, 3, 1000);
+  exp.find_tasks("./assets");
+  exp.run(2);
+
+  // runs stop at the first failure, N = 1, 2, 3 at most
+  ASSERT_GT(exp.runs.size(), 0);
+  for (size_t k = 0; k < exp.runs.size(); ++k) {
+    const auto& r = exp.runs[k];
+    ASSERT_LE(r.N, 3);
+    // bounds from the table shared over N, as from a fresh one
+    for (auto& [map_filename, scen_filename] : exp.tasks) {
+      if (std::filesystem::path(scen_filename).filename() != r.scen_name) {
+        continue;
+      }
+      const auto ins = Instance(scen_filename, map_filename, r.N);
+      auto D = DistTable(ins);
+      ASSERT_EQ(r.makespan_lb, get_makespan_lower_bound(ins, D));
+      ASSERT_EQ(r.sum_of_costs_lb, get_sum_of_costs_lower_bound(ins, D));
+    }
+    if (r.solved) {
+      ASSERT_GE(r.sum_of_costs, r.sum_of_costs_lb);
+      ASSERT_GE(r.makespan, r.makespan_lb);
+    } else {
+      ASSERT_TRUE(k + 1 == exp.runs.size() ||
+                  exp.runs[k + 1].scen_name != r.scen_name);
+    }
+  }
+
+  const auto dir = std::filesystem::temp_directory_path();
+  const auto summary = (dir / "lacam2_test_experiment.csv").string();
+  exp.write_summary(summary);
+  std::ifstream file(summary);
+  std::string line;
+  getline(file, line);
+  ASSERT_EQ(line.rfind("map,N,num_scens,success_rate", 0), 0);
+  auto found = false;
+  while (getline(file, line)) {
+    found |= line.rfind("random-32-32-10.map,3,1,1,", 0) == 0;
+  }
+  ASSERT_TRUE(found);
+  std::filesystem::remove(summary);
+}
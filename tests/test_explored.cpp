@@ -0,0 +1,50 @@
+#include <lacam2.hpp>
+
+#include "gtest/gtest.h"
+
+struct Key {
+  const Config C;
+};
+
+TEST(Explored, find_and_insert)
+{
+  const auto G = Graph("./assets/empty-8-8.map");
+  auto MT = std::mt19937(0);
+  auto keys = std::vector<Key*>();
+  auto EXPLORED = Explored<Key>(4);
+  for (auto k = 0; k < 1000; ++k) {
+    auto C = Config();
+    for (auto i = 0; i < 3; ++i) C.push_back(G.V[get_random_int(&MT, 0, 63)]);
+    if (EXPLORED.find(C) != nullptr) continue;
+    keys.push_back(new Key{C});
+    EXPLORED.insert(keys.back());
+  }
+  ASSERT_EQ(EXPLORED.size(), keys.size());
+  for (auto key : keys) ASSERT_EQ(EXPLORED.find(key->C), key);
+  ASSERT_EQ(EXPLORED.find(Config({G.V[0], G.V[0], G.V[0]})), nullptr);
+
+  // batched lookup
+  const auto C_unknown = Config({G.V[1], G.V[1], G.V[1]});
+  auto Cs = std::vector<const Config*>({&keys[0]->C, &C_unknown, &keys[5]->C});
+  auto hashes = std::vector<uint>();
+  auto res = std::vector<Key*>();
+  EXPLORED.find_batch(Cs, hashes, res);
+  ASSERT_EQ(res[0], keys[0]);
+  ASSERT_EQ(res[1], nullptr);
+  ASSERT_EQ(res[2], keys[5]);
+  ASSERT_EQ(hashes[1], ConfigHasher()(C_unknown));
+
+  // erase half, the rest remains reachable
+  for (size_t k = 0; k < keys.size(); k += 2) {
+    EXPLORED.erase(keys[k], EXPLORED.get_hash(keys[k]->C));
+  }
+  ASSERT_EQ(EXPLORED.num_entries, keys.size() / 2);
+  for (size_t k = 0; k < keys.size(); ++k) {
+    ASSERT_EQ(EXPLORED.find(keys[k]->C), k % 2 == 0 ? nullptr : keys[k]);
+  }
+  EXPLORED.restore(keys[0], EXPLORED.get_hash(keys[0]->C));
+  ASSERT_EQ(EXPLORED.find(keys[0]->C), keys[0]);
+  ASSERT_EQ(EXPLORED.size(), keys.size());
+
+  for (auto key : keys) delete key;
+}
@@ -13,3 +13,25 @@ TEST(Graph, load_graph)
   ASSERT_EQ(G.width, 32);
   ASSERT_EQ(G.height, 32);
 }
+
+TEST(Graph, one_way)
+{
+  const std::string filename = "./assets/loop-oneway.map";
+  auto G = Graph(filename);
+  ASSERT_TRUE(G.directed);
+  ASSERT_EQ(G.size(), 12);
+  // (1,0) leaves only east, (0,0) is free to both
+  auto v = G.U[1];
+  ASSERT_EQ(v->neighbor.size(), 1);
+  ASSERT_EQ(v->neighbor[0], G.U[2]);
+  ASSERT_EQ(G.U[0]->neighbor.size(), 2);
+  // reverse edges
+  ASSERT_EQ(v->in_neighbor.size(), 1);
+  ASSERT_EQ(v->in_neighbor[0], G.U[0]);
+  ASSERT_EQ(G.U[0]->in_neighbor.size(), 1);
+  ASSERT_EQ(G.U[0]->in_neighbor[0], G.U[5]);
+
+  auto G_undirected = Graph("./assets/random-32-32-10.map");
+  ASSERT_FALSE(G_undirected.directed);
+  ASSERT_EQ(G_undirected.V[0]->in_neighbor, G_undirected.V[0]->neighbor);
+}
@@ -0,0 +1,44 @@
+#include <lacam2.hpp>
+
+#include <filesystem>
+
+#include "gtest/gtest.h"
+
+TEST(Heatmap, solve)
+{
+  const auto scen_filename = "./assets/random-32-32-10-random-1.scen";
+  const auto map_filename = "./assets/random-32-32-10.map";
+  const auto ins = Instance(scen_filename, map_filename, 50);
+  auto heatmap = Heatmap(ins.G);
+  auto additional_info = std::string();
+  const auto solution = solve(ins, additional_info, 0, nullptr, nullptr,
+                              OBJ_NONE, 0.001, nullptr, &heatmap);
+  ASSERT_TRUE(is_feasible_solution(ins, solution));
+
+  // every timestep of every agent before its arrival is a move or a wait
+  uint64_t visits = 0, waits = 0;
+  for (size_t k = 0; k < ins.G.U.size(); ++k) {
+    visits += heatmap.values[Heatmap::VISITS][k];
+    waits += heatmap.values[Heatmap::WAITS][k];
+    if (ins.G.U[k] == nullptr) {
+      ASSERT_EQ(heatmap.values[Heatmap::VISITS][k], 0);
+    }
+  }
+  ASSERT_EQ(visits + waits, get_sum_of_costs(solution) + ins.N);
+  ASSERT_EQ(heatmap.values[Heatmap::VISITS][ins.starts[0]->index] > 0, true);
+
+  // output
+  const auto dir = std::filesystem::temp_directory_path();
+  const auto csv = (dir / "lacam2_test_heatmap.csv").string();
+  const auto bin = (dir / "lacam2_test_heatmap.bin").string();
+  ASSERT_TRUE(heatmap.write(csv));
+  ASSERT_TRUE(heatmap.write(bin));
+  auto file = std::ifstream(csv);
+  auto lines = 0;
+  for (std::string line; std::getline(file, line);) ++lines;
+  ASSERT_EQ(lines, ins.G.size() + 1);
+  ASSERT_EQ(std::filesystem::file_size(bin),
+            4 + 3 * 4 + Heatmap::NUM_METRICS * ins.G.U.size() * 8);
+  std::filesystem::remove(csv);
+  std::filesystem::remove(bin);
+}
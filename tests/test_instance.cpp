@@ -13,3 +13,17 @@ TEST(Instance, initialize)
   ASSERT_EQ(ins.starts[0]->index, 203);
   ASSERT_EQ(ins.goals[0]->index, 583);
 }
+
+TEST(Instance, prefix)
+{
+  const auto scen_filename = "./assets/random-32-32-10-random-1.scen";
+  const auto map_filename = "./assets/random-32-32-10.map";
+  const auto ins = Instance(scen_filename, map_filename, 10);
+  const auto ins_prefix = Instance(ins, 3);
+
+  ASSERT_EQ(&ins_prefix.G, &ins.G);
+  ASSERT_EQ(ins_prefix.N, 3);
+  ASSERT_TRUE(ins_prefix.is_valid());
+  ASSERT_EQ(ins_prefix.starts[0]->index, 203);
+  ASSERT_EQ(ins_prefix.goals[0]->index, 583);
+}
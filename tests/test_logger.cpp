@@ -0,0 +1,63 @@
+#include <lacam2.hpp>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+
+TEST(Logger, sync)
+{
+  auto lines = std::string();
+  Logger::clear_sinks();
+  Logger::add_sink([&](const std::string& s) { lines += s; });
+  info(1, 0, "hidden");
+  info(0, 0, "a=", 1, ", b=", std::setw(3), 2);
+  ASSERT_EQ(lines, "a=1, b=  2\n");  // written at once
+  Logger::clear_sinks();
+  Logger::add_stdout_sink();
+}
+
+TEST(Logger, async)
+{
+  // lines of each thread in order, none lost
+  auto lines = std::vector<std::string>();
+  Logger::clear_sinks();
+  Logger::add_sink([&](const std::string& s) {
+    std::istringstream iss(s);
+    for (std::string line; std::getline(iss, line);) lines.push_back(line);
+  });
+  Logger::start();
+  ASSERT_TRUE(Logger::is_async());
+  const int num_threads = 4;
+  const int num_lines = 20000;  // more than the queue
+  auto threads = std::vector<std::thread>();
+  for (int k = 0; k < num_threads; ++k) {
+    threads.emplace_back([k]() {
+      for (int i = 0; i < num_lines; ++i) info(0, 0, k, " ", i);
+    });
+  }
+  for (auto& th : threads) th.join();
+  Logger::flush();
+  ASSERT_EQ(lines.size(), num_threads * num_lines);
+  auto next = std::vector<int>(num_threads, 0);
+  for (auto& line : lines) {
+    int k, i;
+    std::istringstream(line) >> k >> i;
+    ASSERT_EQ(i, next[k]++);
+  }
+
+  // the child of fork() logs by itself
+  const auto pid = fork();
+  if (pid == 0) _exit(Logger::is_async() ? 1 : 0);
+  int status;
+  waitpid(pid, &status, 0);
+  ASSERT_EQ(WEXITSTATUS(status), 0);
+
+  // drained when stopped
+  info(0, 0, "last");
+  Logger::stop();
+  ASSERT_FALSE(Logger::is_async());
+  ASSERT_EQ(lines.back(), "last");
+  Logger::clear_sinks();
+  Logger::add_stdout_sink();
+}
@@ -0,0 +1,27 @@
+#include <lacam2.hpp>
+
+#include "gtest/gtest.h"
+
+TEST(PerfCounters, phases)
+{
+  auto perf = PerfCounters({"a", "b"}, true);
+  for (auto k = 0; k < 3; ++k) {
+    perf.start();
+    volatile uint64_t sum = 0;
+    for (auto i = 0; i < 100000; ++i) sum += i;
+    perf.stop(k % 2);
+  }
+  const auto stats = perf.get_stats();
+  if (perf.available) {
+    // counters are monotone, the busy loop takes cycles
+    ASSERT_EQ(perf.num_calls[0], 2);
+    ASSERT_EQ(perf.num_calls[1], 1);
+    ASSERT_GT(perf.totals[0][PerfCounters::INSTRUCTIONS], 0);
+    ASSERT_NE(stats.find("perf_b_cycles="), std::string::npos);
+    ASSERT_LE(perf.time_running, perf.time_enabled);
+    ASSERT_NE(stats.find("perf_multiplexed="), std::string::npos);
+  } else {
+    // degrade gracefully
+    ASSERT_EQ(stats, "perf_available=0\n");
+  }
+}
@@ -1,5 +1,7 @@
 #include <lacam2.hpp>
 
+#include <filesystem>
+
 #include "gtest/gtest.h"
 
 TEST(planner, solve)
@@ -19,14 +21,137 @@ TEST(planner, optimizer)
   const auto map_filename = "./assets/loop.map";
   const auto ins = Instance(scen_filename, map_filename, 3);
   auto additional_info = std::string();
+  auto options = PlannerOptions();
+  options.refine = true;
 
   auto solution_m =
-      solve(ins, additional_info, 0, nullptr, nullptr, Objective::OBJ_MAKESPAN);
+      solve(ins, additional_info, 0, nullptr, nullptr, Objective::OBJ_MAKESPAN,
+            0.001, nullptr, nullptr, nullptr, options);
   ASSERT_TRUE(is_feasible_solution(ins, solution_m));
   ASSERT_TRUE(get_makespan(solution_m) == 10);
 
   auto solution_l = solve(ins, additional_info, 0, nullptr, nullptr,
-                          Objective::OBJ_SUM_OF_LOSS);
+                          Objective::OBJ_SUM_OF_LOSS, 0.001, nullptr, nullptr,
+                          nullptr, options);
   ASSERT_TRUE(is_feasible_solution(ins, solution_l));
   ASSERT_TRUE(get_sum_of_loss(solution_l) == 15);
+
+  // stop at the first solution by default
+  additional_info.clear();
+  auto solution_first = solve(ins, additional_info, 0, nullptr, nullptr,
+                              Objective::OBJ_MAKESPAN);
+  ASSERT_TRUE(is_feasible_solution(ins, solution_first));
+  ASSERT_NE(additional_info.find("optimal=0"), std::string::npos);
+}
+
+TEST(planner, compaction)
+{
+  const auto scen_filename = "./assets/loop.scen";
+  const auto map_filename = "./assets/loop.map";
+  const auto ins = Instance(scen_filename, map_filename, 3);
+  auto options = PlannerOptions();
+  options.refine = true;
+
+  for (auto objective : {OBJ_MAKESPAN, OBJ_SUM_OF_LOSS}) {
+    auto additional_info = std::string();
+    options.gc_interval = 0;
+    const auto solution_ref = solve(ins, additional_info, 0, nullptr, nullptr,
+                                    objective, 0.001, nullptr, nullptr,
+                                    nullptr, options);
+    ASSERT_NE(additional_info.find("num_node_compacted=0"), std::string::npos);
+
+    // dominated nodes are freed during refinement
+    additional_info.clear();
+    options.gc_interval = 1;
+    const auto solution = solve(ins, additional_info, 0, nullptr, nullptr,
+                                objective, 0.001, nullptr, nullptr, nullptr,
+                                options);
+    ASSERT_TRUE(is_feasible_solution(ins, solution));
+    const auto key = std::string("num_node_compacted=");
+    const auto pos = additional_info.find(key);
+    ASSERT_NE(pos, std::string::npos);
+    ASSERT_GT(std::stoul(additional_info.substr(pos + key.size())), 0);
+    if (objective == OBJ_MAKESPAN) {
+      ASSERT_LE(get_makespan(solution), get_makespan(solution_ref));
+    } else {
+      ASSERT_LE(get_sum_of_loss(solution), get_sum_of_loss(solution_ref));
+    }
+  }
+}
+
+TEST(planner, cold_store)
+{
+  const auto scen_filename = "./assets/random-32-32-10-random-1.scen";
+  const auto map_filename = "./assets/random-32-32-10.map";
+  const auto ins = Instance(scen_filename, map_filename, 50);
+  const auto dir =
+      (std::filesystem::temp_directory_path() / "lacam2_test_planner_cold")
+          .string();
+  auto additional_info = std::string();
+  auto options = PlannerOptions();
+  options.cold_dir = dir;
+  options.hot_capacity = 16;
+
+  auto solution = solve(ins, additional_info, 0, nullptr, nullptr, OBJ_NONE,
+                        0.001, nullptr, nullptr, nullptr, options);
+  ASSERT_TRUE(is_feasible_solution(ins, solution));
+  const auto key = std::string("num_node_spilled=");
+  const auto pos = additional_info.find(key);
+  ASSERT_NE(pos, std::string::npos);
+  ASSERT_GT(std::stoul(additional_info.substr(pos + key.size())), 0);
+  ASSERT_NE(additional_info.find("cold_failed=0"), std::string::npos);
+
+  // unwritable directory, the search continues in memory
+  additional_info.clear();
+  options.cold_dir = "/dev/null/lacam2";
+  solution = solve(ins, additional_info, 0, nullptr, nullptr, OBJ_NONE, 0.001,
+                   nullptr, nullptr, nullptr, options);
+  ASSERT_TRUE(is_feasible_solution(ins, solution));
+  ASSERT_NE(additional_info.find("num_node_spilled=0"), std::string::npos);
+  std::filesystem::remove_all(dir);
+}
+
+TEST(planner, pibt_stats)
+{
+  const auto scen_filename = "./assets/random-32-32-10-random-1.scen";
+  const auto map_filename = "./assets/random-32-32-10.map";
+  const auto ins = Instance(scen_filename, map_filename, 50);
+  auto MT = std::mt19937(0);
+
+  auto options = PlannerOptions();
+  options.pibt_stats = true;
+  auto planner =
+      Planner(&ins, nullptr, &MT, 0, OBJ_NONE, 0.001, nullptr, options);
+  auto additional_info = std::string();
+  auto solution = planner.solve(additional_info);
+  ASSERT_TRUE(is_feasible_solution(ins, solution));
+
+  const auto& stats = planner.workers[0]->stats;
+  ASSERT_GT(stats.num_calls, 0);
+  ASSERT_EQ(stats.depth_at_fail.total(),
+            stats.num_fail_constraints + stats.num_fail_pibt);
+  // every top-level call places at least one agent
+  ASSERT_EQ(stats.chain_depth.bins[0], 0);
+  ASSERT_GE(stats.num_candidates.total(), stats.chain_depth.total());
+  ASSERT_NE(additional_info.find("pibt_chain_depth_hist="), std::string::npos);
+}
+
+TEST(planner, one_way)
+{
+  // U indexes; agents rotate clockwise without overtaking
+  const auto ins = Instance("./assets/loop-oneway.map",
+                            std::vector<uint>({0, 2, 9}),
+                            std::vector<uint>({1, 14, 5}));
+  auto additional_info = std::string();
+  auto solution = solve(ins, additional_info);
+  // moves against lanes are rejected by the feasibility check
+  ASSERT_TRUE(is_feasible_solution(ins, solution));
+
+  // next to the goal, against the lane
+  const auto ins_around = Instance("./assets/loop-oneway.map",
+                                   std::vector<uint>({1}),
+                                   std::vector<uint>({0}));
+  solution = solve(ins_around, additional_info);
+  ASSERT_TRUE(is_feasible_solution(ins_around, solution));
+  ASSERT_EQ(get_makespan(solution), 11);
 }
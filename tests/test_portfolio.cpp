@@ -0,0 +1,240 @@
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <lacam2.hpp>
+
+#include "gtest/gtest.h"
+
+// listening on a free loopback port
+static int listen_loopback(int& port)
+{
+  const auto fd = socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t addr_len = sizeof(addr);
+  if (bind(fd, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, 1) != 0 ||
+      getsockname(fd, (sockaddr*)&addr, &addr_len) != 0) {
+    close(fd);
+    return -1;
+  }
+  port = ntohs(addr.sin_port);
+  return fd;
+}
+
+// one line without the newline, empty on EOF
+static std::string recv_line(const int fd)
+{
+  auto line = std::string();
+  char c;
+  while (recv(fd, &c, 1, 0) == 1 && c != '\n') line.push_back(c);
+  return line;
+}
+
+static void send_line(const int fd, const std::string& line)
+{
+  send(fd, line.data(), line.size(), MSG_NOSIGNAL);
+}
+
+// retries until the coordinator listens
+static int connect_loopback(const int port)
+{
+  const auto fd = socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons(port);
+  for (auto k = 0; k < 100; ++k) {
+    if (connect(fd, (sockaddr*)&addr, sizeof(addr)) == 0) break;
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return fd;
+}
+
+// RESULT line of config id
+static std::string result_line(const int id, const Instance& ins,
+                               const Solution& solution)
+{
+  std::stringstream ss;
+  ss << "RESULT " << id << " 1 0 " << solution.size() << " " << ins.N;
+  for (auto& C : solution) {
+    for (auto v : C) ss << " " << v->index;
+  }
+  return ss.str() + "\n";
+}
+
+TEST(Portfolio, first)
+{
+  const auto scen_filename = "./assets/random-32-32-10-random-1.scen";
+  const auto map_filename = "./assets/random-32-32-10.map";
+  const auto ins = Instance(scen_filename, map_filename, 50);
+  auto configs = std::vector<PortfolioConfig>();
+  for (auto k = 0; k < 4; ++k) configs.push_back({k, 0.001, OBJ_NONE});
+  auto portfolio = Portfolio(ins, configs, PORTFOLIO_FIRST);
+  const auto deadline = Deadline(10000);
+  auto additional_info = std::string();
+  const auto solution = portfolio.coordinate(&deadline, 2, additional_info);
+  ASSERT_TRUE(is_feasible_solution(ins, solution));
+  ASSERT_GE(portfolio.winner, 0);
+  ASSERT_EQ(portfolio.num_workers, 2);
+  ASSERT_GT(portfolio.port, 0);
+  ASSERT_NE(additional_info.find("portfolio_seed="), std::string::npos);
+}
+
+TEST(Portfolio, best)
+{
+  const auto scen_filename = "./assets/random-32-32-10-random-1.scen";
+  const auto map_filename = "./assets/random-32-32-10.map";
+  const auto ins = Instance(scen_filename, map_filename, 50);
+  auto configs = std::vector<PortfolioConfig>();
+  for (auto k = 0; k < 3; ++k) configs.push_back({k, 0.01f * k, OBJ_NONE});
+  auto portfolio = Portfolio(ins, configs, PORTFOLIO_BEST);
+  const auto deadline = Deadline(20000);
+  auto additional_info = std::string();
+  const auto solution = portfolio.coordinate(&deadline, 2, additional_info);
+  ASSERT_TRUE(is_feasible_solution(ins, solution));
+  ASSERT_EQ(portfolio.num_results, 3);
+
+  // the winner is no worse than any single configuration
+  for (auto& cfg : configs) {
+    const auto d = Deadline(20000);
+    auto MT = std::mt19937(cfg.seed);
+    auto info = std::string();
+    const auto sol = solve(ins, info, 0, &d, &MT, cfg.objective,
+                           cfg.restart_rate);
+    ASSERT_FALSE(portfolio.is_better(sol, solution));
+  }
+}
+
+TEST(Portfolio, cancel)
+{
+  // the worker refines until a long time limit unless cancelled
+  const auto scen_filename = "./assets/random-32-32-10-random-1.scen";
+  const auto map_filename = "./assets/random-32-32-10.map";
+  const auto ins = Instance(scen_filename, map_filename, 50);
+  auto port = 0;
+  const auto listen_fd = listen_loopback(port);
+  ASSERT_GE(listen_fd, 0);
+  auto options = PlannerOptions();
+  options.refine = true;
+  auto worker = std::thread(
+      [&]() { portfolio_worker(ins, "127.0.0.1", port, 0, options); });
+  const auto fd = accept(listen_fd, nullptr, nullptr);
+  EXPECT_EQ(recv_line(fd), "HELLO");
+
+  const auto timer = Deadline(60000);
+  send_line(fd, "SOLVE 0 0 0.001 2 60000\n");  // OBJ_SUM_OF_LOSS
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+  send_line(fd, "CANCEL\n");
+  const auto line = recv_line(fd);
+  const auto elapsed = timer.elapsed_ms();
+  send_line(fd, "BYE\n");
+  worker.join();
+  close(fd);
+  close(listen_fd);
+
+  // the best solution so far, well before the time limit
+  EXPECT_EQ(line.rfind("RESULT 0 1 ", 0), 0);
+  EXPECT_LT(elapsed, 5000);
+}
+
+TEST(Portfolio, unexpected_result)
+{
+  // a result of another job is not taken as a solution
+  const auto scen_filename = "./assets/random-32-32-10-random-1.scen";
+  const auto map_filename = "./assets/random-32-32-10.map";
+  const auto ins = Instance(scen_filename, map_filename, 5);
+  auto additional_info = std::string();
+  const auto solution = solve(ins, additional_info);
+  ASSERT_TRUE(is_feasible_solution(ins, solution));
+
+  // a free port, taken again by the coordinator
+  auto port = 0;
+  close(listen_loopback(port));
+  auto configs = std::vector<PortfolioConfig>({{0, 0.001, OBJ_NONE}});
+  auto portfolio = Portfolio(ins, configs, PORTFOLIO_FIRST, port);
+  auto worker = std::thread([&]() {
+    const auto fd = connect_loopback(port);
+    send_line(fd, "HELLO\n");
+    recv_line(fd);  // SOLVE 0 ...
+    send_line(fd, result_line(7, ins, solution));  // unknown config
+    send_line(fd, "RESULT 0 0 0 0 " + std::to_string(ins.N) + "\n");
+    recv_line(fd);  // BYE
+    close(fd);
+  });
+  const auto deadline = Deadline(10000);
+  const auto res = portfolio.coordinate(&deadline, 0, additional_info);
+  worker.join();
+  ASSERT_TRUE(res.empty());
+  ASSERT_EQ(portfolio.winner, -1);
+  ASSERT_EQ(portfolio.num_results, 1);
+}
+
+TEST(Portfolio, invalid_result)
+{
+  // obstacles and infeasible solutions are dropped
+  const auto scen_filename = "./assets/random-32-32-10-random-1.scen";
+  const auto map_filename = "./assets/random-32-32-10.map";
+  const auto ins = Instance(scen_filename, map_filename, 5);
+  auto additional_info = std::string();
+  const auto solution = solve(ins, additional_info);
+  ASSERT_TRUE(is_feasible_solution(ins, solution));
+  auto on_obstacle = solution;
+  for (uint k = 0; k < ins.G.U.size(); ++k) {
+    if (ins.G.U[k] != nullptr) continue;
+    on_obstacle[1][0] = new Vertex(ins.G.V.size(), k);
+    break;
+  }
+  ASSERT_NE(on_obstacle[1][0], solution[1][0]);
+  const auto teleport = Solution({ins.starts, ins.goals});
+
+  auto port = 0;
+  close(listen_loopback(port));
+  auto configs = std::vector<PortfolioConfig>(
+      {{0, 0.001, OBJ_NONE}, {1, 0.001, OBJ_NONE}});
+  auto portfolio = Portfolio(ins, configs, PORTFOLIO_FIRST, port);
+  auto worker = std::thread([&]() {
+    const auto fd = connect_loopback(port);
+    send_line(fd, "HELLO\n");
+    recv_line(fd);  // SOLVE 0 ...
+    send_line(fd, result_line(0, ins, on_obstacle));
+    recv_line(fd);  // SOLVE 1 ...
+    send_line(fd, result_line(1, ins, teleport));
+    recv_line(fd);  // BYE
+    close(fd);
+  });
+  const auto deadline = Deadline(10000);
+  const auto res = portfolio.coordinate(&deadline, 0, additional_info);
+  worker.join();
+  delete on_obstacle[1][0];
+  ASSERT_TRUE(res.empty());
+  ASSERT_EQ(portfolio.winner, -1);
+  ASSERT_EQ(portfolio.num_results, 2);
+}
+
+TEST(Portfolio, workers_gone)
+{
+  // without a deadline, the coordinator returns once all workers have gone
+  const auto scen_filename = "./assets/random-32-32-10-random-1.scen";
+  const auto map_filename = "./assets/random-32-32-10.map";
+  const auto ins = Instance(scen_filename, map_filename, 5);
+  auto port = 0;
+  close(listen_loopback(port));
+  // config 1 is never handed out
+  auto configs = std::vector<PortfolioConfig>(
+      {{0, 0.001, OBJ_NONE}, {1, 0.001, OBJ_NONE}});
+  auto portfolio = Portfolio(ins, configs, PORTFOLIO_FIRST, port);
+  auto worker = std::thread([&]() {
+    const auto fd = connect_loopback(port);
+    send_line(fd, "HELLO\n");
+    recv_line(fd);  // SOLVE 0 ...
+    close(fd);      // without a result
+  });
+  auto additional_info = std::string();
+  const auto res = portfolio.coordinate(nullptr, 0, additional_info);
+  worker.join();
+  ASSERT_TRUE(res.empty());
+  ASSERT_EQ(portfolio.num_workers, 1);
+}
@@ -64,3 +64,110 @@ TEST(PostProcessing, metrics)
   ASSERT_EQ(get_makespan(sol), 2);
   ASSERT_EQ(get_sum_of_costs(sol), 4);
 }
+
+TEST(PostProcessing, solution_diff)
+{
+  const auto scen_filename = "./assets/random-32-32-10-random-1.scen";
+  const auto map_filename = "./assets/random-32-32-10.map";
+  const auto ins = Instance(scen_filename, map_filename, 50);
+  auto additional_info = std::string();
+  auto MT = std::mt19937(0);
+  const auto prev = solve(ins, additional_info, 0, nullptr, &MT);
+
+  // round trip via the result file
+  const auto filename = std::string("./test_solution_diff.txt");
+  make_log(ins, prev, filename, 0, map_filename, 0, additional_info);
+  const auto loaded = load_solution(ins, filename);
+  std::remove(filename.c_str());
+  ASSERT_EQ(loaded, prev);
+
+  // identical
+  auto diff = get_solution_diff(prev, prev);
+  ASSERT_TRUE(diff.paths.empty());
+  ASSERT_EQ(apply_solution_diff(prev, diff), prev);
+
+  // another seed
+  auto MT_next = std::mt19937(1);
+  const auto next = solve(ins, additional_info, 0, nullptr, &MT_next);
+  diff = get_solution_diff(prev, next);
+  ASSERT_FALSE(diff.paths.empty());
+  ASSERT_EQ(apply_solution_diff(prev, diff), next);
+  for (auto& path : diff.paths) {
+    const auto t = path.t_diverge;
+    ASSERT_NE(prev[std::min((size_t)t, prev.size() - 1)][path.agent],
+              next[std::min((size_t)t, next.size() - 1)][path.agent]);
+  }
+
+  // without previous solution, every agent
+  diff = get_solution_diff(Solution(), next);
+  ASSERT_EQ(diff.paths.size(), ins.N);
+  ASSERT_EQ(apply_solution_diff(Solution(), diff), next);
+}
+
+TEST(PostProcessing, json_log)
+{
+  // serializer
+  auto json = JsonWriter();
+  json.begin_object();
+  json.key("a").value(1).key("b").value(-2.5).key("c").value(true);
+  json.key("s").value("x\"\n");
+  json.key("n").value_of_text("12").key("h").value_of_text("0,3,5");
+  json.key("t").value_of_text("none").key("e").value_of_text("");
+  json.key("l").begin_array().end_array();
+  json.end_object();
+  ASSERT_EQ(json.buf,
+            R"({"a":1,"b":-2.5,"c":true,"s":"x\"\n","n":12,"h":[0,3,5],)"
+            R"("t":"none","e":"","l":[]})");
+
+  // not JSON numbers, quoted
+  for (auto text : {"01", "1.", "-.5", ".5", "+1", "1e", "inf", "nan", "-",
+                    "0x1", "1,", "1,,2", "1, 2"}) {
+    auto w = JsonWriter();
+    w.value_of_text(text);
+    ASSERT_EQ(w.buf, "\"" + std::string(text) + "\"") << text;
+  }
+  for (auto text : {"0", "-0", "10", "-1.25", "1e5", "2.5E-3", "0.0"}) {
+    auto w = JsonWriter();
+    w.value_of_text(text);
+    ASSERT_EQ(w.buf, text);
+  }
+
+  const auto scen_filename = "./assets/random-32-32-10-random-1.scen";
+  const auto map_filename = "./assets/random-32-32-10.map";
+  const auto ins = Instance(scen_filename, map_filename, 20);
+  auto additional_info = std::string();
+  auto MT = std::mt19937(0);
+  const auto solution = solve(ins, additional_info, 0, nullptr, &MT);
+  const auto stats =
+      get_log_stats(ins, solution, 1.5, map_filename, 0, additional_info);
+
+  // JSON lines, appended
+  const auto filename = std::string("./test_json_log.jsonl");
+  std::remove(filename.c_str());
+  make_json_log(ins, solution, filename, stats, {{"solve_ms", 1.5}}, true,
+                true);
+  make_json_log(ins, solution, filename, stats, {}, false, true);
+  std::ifstream file(filename);
+  auto lines = std::vector<std::string>();
+  for (std::string line; getline(file, line);) lines.push_back(line);
+  std::remove(filename.c_str());
+  ASSERT_EQ(lines.size(), 2);
+  ASSERT_EQ(lines[0].front(), '{');
+  ASSERT_EQ(lines[0].back(), '}');
+  ASSERT_EQ(lines[0].find(R"({"agents":20,"map_file":"random-32-32-10.map",)"
+                          R"("solver":"planner","solved":1,)"),
+            0);
+  ASSERT_NE(lines[0].find(R"("soc":)" +
+                          std::to_string(get_sum_of_costs(solution)) + ","),
+            std::string::npos);
+  ASSERT_NE(lines[0].find(R"("comp_time":1.5,)"), std::string::npos);
+  ASSERT_NE(lines[0].find(R"("loop_cnt":)"), std::string::npos);
+  ASSERT_NE(lines[0].find(R"("timing":{"solve_ms":1.5})"), std::string::npos);
+  ASSERT_EQ(lines[0].find(R"("solution")"), std::string::npos);
+  ASSERT_EQ(lines[1].find(R"("timing")"), std::string::npos);
+  const auto k = ins.starts[0]->index;
+  ASSERT_NE(lines[1].find(R"("starts":[[)" + std::to_string(k % ins.G.width) +
+                          "," + std::to_string(k / ins.G.width) + "]"),
+            std::string::npos);
+  ASSERT_NE(lines[1].find(R"("solution":[[[)"), std::string::npos);
+}
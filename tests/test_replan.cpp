@@ -0,0 +1,72 @@
+#include <lacam2.hpp>
+
+#include "gtest/gtest.h"
+
+TEST(ReservationTable, conflicts)
+{
+  const auto ins = Instance("./assets/empty-8-8.map", std::vector<uint>({0}),
+                            std::vector<uint>({2}));
+  auto RT = ReservationTable(ins.G.size());
+  RT.add(Config({ins.G.U[0], ins.G.U[1], ins.G.U[2]}));
+  ASSERT_TRUE(RT.is_occupied(1, ins.G.U[1]));
+  ASSERT_FALSE(RT.is_occupied(2, ins.G.U[1]));
+  ASSERT_TRUE(RT.is_occupied(100, ins.G.U[2]));  // staying at the end
+  ASSERT_FALSE(RT.is_valid_move(0, ins.G.U[1], ins.G.U[0]));  // swap
+  ASSERT_TRUE(RT.is_valid_move(0, ins.G.U[1], ins.G.U[9]));
+
+  // waits for the reserved cell, then stays at the goal forever
+  const auto path =
+      get_space_time_path(ins.G, RT, ins.G.U[9], ins.G.U[1], nullptr);
+  ASSERT_FALSE(path.empty());
+  ASSERT_EQ(path.front(), ins.G.U[9]);
+  ASSERT_EQ(path.back(), ins.G.U[1]);
+  ASSERT_GE(path.size(), 3);
+
+  // goal where a fixed path ends
+  ASSERT_TRUE(
+      get_space_time_path(ins.G, RT, ins.G.U[9], ins.G.U[2], nullptr).empty());
+}
+
+TEST(replan, subset)
+{
+  const auto scen_filename = "./assets/random-32-32-10-random-1.scen";
+  const auto map_filename = "./assets/random-32-32-10.map";
+  const auto ins = Instance(scen_filename, map_filename, 100);
+  auto additional_info = std::string();
+  const auto solution = solve(ins, additional_info);
+  ASSERT_TRUE(is_feasible_solution(ins, solution));
+
+  // new goals, unused by others
+  const auto agents = std::vector<uint>({3, 17, 42});
+  auto used = std::vector<bool>(ins.G.size(), false);
+  for (auto v : ins.goals) used[v->id] = true;
+  auto new_goals = Config();
+  for (auto v : ins.G.V) {
+    if (new_goals.size() == agents.size()) break;
+    if (!used[v->id]) new_goals.push_back(v);
+  }
+
+  const auto merged = replan(ins, solution, agents, new_goals);
+  ASSERT_FALSE(merged.empty());
+
+  auto start_indexes = std::vector<uint>();
+  auto goal_indexes = std::vector<uint>();
+  for (uint i = 0; i < ins.N; ++i) {
+    start_indexes.push_back(ins.starts[i]->index);
+    goal_indexes.push_back(ins.goals[i]->index);
+  }
+  for (size_t k = 0; k < agents.size(); ++k) {
+    goal_indexes[agents[k]] = new_goals[k]->index;
+  }
+  const auto ins_new = Instance(map_filename, start_indexes, goal_indexes);
+  ASSERT_TRUE(is_feasible_solution(ins_new, merged));
+
+  // others keep their paths
+  for (uint i = 0; i < ins.N; ++i) {
+    if (std::find(agents.begin(), agents.end(), i) != agents.end()) continue;
+    for (size_t t = 0; t < merged.size(); ++t) {
+      ASSERT_EQ(merged[t][i]->index,
+                solution[std::min(t, solution.size() - 1)][i]->index);
+    }
+  }
+}
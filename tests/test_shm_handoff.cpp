@@ -0,0 +1,105 @@
+#include <lacam2.hpp>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+
+TEST(ShmSegment, handoff)
+{
+  const auto scen_filename = "./assets/random-32-32-10-random-1.scen";
+  const auto map_filename = "./assets/random-32-32-10.map";
+  const auto ins = Instance(scen_filename, map_filename, 50);
+  auto additional_info = std::string();
+  const auto solution = solve(ins, additional_info);
+  ASSERT_TRUE(is_feasible_solution(ins, solution));
+
+  const auto name = "/lacam2_test_" + std::to_string(getpid());
+  auto client = ShmSegment(name);
+  ASSERT_TRUE(client.is_open());
+  ASSERT_FALSE(client.wait(10));  // nothing published yet
+
+  // writer in another process
+  const auto pid = fork();
+  if (pid == 0) {
+    usleep(20000);
+    auto writer = ShmSegment(name);
+    _exit(writer.publish(ins, solution, 1.5) ? 0 : 1);
+  }
+  ASSERT_TRUE(client.wait(5000));
+  int status;
+  waitpid(pid, &status, 0);
+  ASSERT_EQ(WEXITSTATUS(status), 0);
+
+  const auto h = client.header();
+  ASSERT_EQ(h->state.load(), SHM_READY);
+  ASSERT_EQ(h->magic, ShmHeader::MAGIC);
+  ASSERT_EQ(h->N, ins.N);
+  ASSERT_EQ(h->T, solution.size());
+  ASSERT_EQ(h->width, ins.G.width);
+  ASSERT_EQ(h->comp_time_ms, 1.5);
+  for (uint t = 0; t < solution.size(); ++t) {
+    for (uint i = 0; i < ins.N; ++i) {
+      ASSERT_EQ(client.get(t, i), solution[t][i]->index);
+    }
+  }
+  client.unlink();
+}
+
+TEST(ShmSegment, failure)
+{
+  const auto ins = Instance("./assets/empty-8-8.map", std::vector<uint>({0}),
+                            std::vector<uint>({1}));
+  const auto name = "/lacam2_test_failure_" + std::to_string(getpid());
+  auto writer = ShmSegment(name);
+  ASSERT_TRUE(writer.publish(ins, Solution(), 0));
+  auto client = ShmSegment(name);
+  ASSERT_TRUE(client.wait(0));
+  ASSERT_EQ(client.header()->state.load(), SHM_FAILED);
+  ASSERT_EQ(client.header()->T, 0);
+  client.unlink();
+}
+
+TEST(ShmSegment, republish)
+{
+  const auto map_filename = "./assets/empty-8-8.map";
+  const auto ins_1 = Instance(map_filename, std::vector<uint>({0, 9}),
+                              std::vector<uint>({2, 9}));
+  const auto ins_2 = Instance(map_filename, std::vector<uint>({0, 7, 63}),
+                              std::vector<uint>({1, 7, 62}));
+  auto additional_info = std::string();
+  const auto solution_1 = solve(ins_1, additional_info);
+  const auto solution_2 = solve(ins_2, additional_info);
+  ASSERT_TRUE(is_feasible_solution(ins_1, solution_1));
+  ASSERT_TRUE(is_feasible_solution(ins_2, solution_2));
+
+  const auto name = "/lacam2_test_republish_" + std::to_string(getpid());
+  auto writer = ShmSegment(name);
+  auto client = ShmSegment(name);
+  auto check = [&](const Instance& ins, const Solution& solution) {
+    ASSERT_TRUE(client.wait(5000));
+    ASSERT_EQ(client.header()->state.load(), SHM_READY);
+    ASSERT_EQ(client.header()->N, ins.N);
+    ASSERT_EQ(client.header()->T, solution.size());
+    for (uint t = 0; t < solution.size(); ++t) {
+      for (uint i = 0; i < ins.N; ++i) {
+        ASSERT_EQ(client.get(t, i), solution[t][i]->index);
+      }
+    }
+  };
+
+  ASSERT_TRUE(writer.publish(ins_1, solution_1, 1));
+  check(ins_1, solution_1);
+  // the first result is not taken again
+  ASSERT_FALSE(client.wait(10));
+  writer.invalidate();
+  ASSERT_FALSE(client.wait(10));
+  ASSERT_TRUE(writer.publish(ins_2, solution_2, 2));
+  check(ins_2, solution_2);
+
+  // a new client does not take an outdated result during the next search
+  writer.invalidate();
+  auto late = ShmSegment(name);
+  ASSERT_FALSE(late.wait(10));
+  client.unlink();
+}
@@ -0,0 +1,59 @@
+#include <lacam2.hpp>
+
+#include "gtest/gtest.h"
+
+TEST(SIPP, intervals)
+{
+  const auto ins = Instance("./assets/empty-8-8.map", std::vector<uint>({0}),
+                            std::vector<uint>({2}));
+  auto RT = ReservationTable(ins.G.size());
+  RT.add(Config({ins.G.U[0], ins.G.U[1], ins.G.U[2]}));
+  auto sipp = SIPP(ins.G, RT);
+  auto get = [&](uint index) {
+    const auto v = ins.G.U[index]->id;
+    return std::vector<std::pair<uint, uint> >(
+        sipp.intervals.begin() + sipp.offsets[v],
+        sipp.intervals.begin() + sipp.offsets[v + 1]);
+  };
+  using I = std::vector<std::pair<uint, uint> >;
+  ASSERT_EQ(get(0), I({{1, UINT_MAX}}));
+  ASSERT_EQ(get(1), I({{0, 1}, {2, UINT_MAX}}));
+  ASSERT_EQ(get(2), I({{0, 2}}));
+  ASSERT_EQ(get(3), I({{0, UINT_MAX}}));
+}
+
+TEST(SIPP, same_as_space_time_astar)
+{
+  // agents 0..49: fixed paths, 50..: queries
+  const auto scen_filename = "./assets/random-32-32-10-random-1.scen";
+  const auto map_filename = "./assets/random-32-32-10.map";
+  const auto ins = Instance(scen_filename, map_filename, 100);
+  const auto ins_fixed = Instance(ins, 50);
+  auto additional_info = std::string();
+  const auto solution = solve(ins_fixed, additional_info);
+  ASSERT_FALSE(solution.empty());
+
+  auto RT = ReservationTable(ins.G.size());
+  for (uint i = 0; i < ins_fixed.N; ++i) {
+    auto path = Config();
+    for (auto& C : solution) path.push_back(C[i]);
+    RT.add(path);
+  }
+  auto sipp = SIPP(ins.G, RT);
+  auto D = DistTable(ins);
+  uint num_solved = 0;
+  for (uint i = ins_fixed.N; i < ins.N; ++i) {
+    const auto expected =
+        get_space_time_path(ins.G, RT, ins.starts[i], ins.goals[i]);
+    const auto path = sipp.find_path(ins.starts[i], D, i);
+    ASSERT_EQ(path.size(), expected.size());
+    if (path.empty()) continue;
+    ++num_solved;
+    ASSERT_EQ(path.front(), ins.starts[i]);
+    ASSERT_EQ(path.back(), ins.goals[i]);
+    for (size_t t = 0; t + 1 < path.size(); ++t) {
+      ASSERT_TRUE(RT.is_valid_move(t, path[t], path[t + 1]));
+    }
+  }
+  ASSERT_GT(num_solved, 0);
+}
@@ -0,0 +1,107 @@
+#include <lacam2.hpp>
+
+#include <filesystem>
+
+#include "gtest/gtest.h"
+
+// keys of key=value lines
+static std::vector<std::string> get_keys(const std::string& additional_info)
+{
+  auto keys = std::vector<std::string>();
+  auto iss = std::istringstream(additional_info);
+  for (std::string line; std::getline(iss, line);) {
+    keys.push_back(line.substr(0, line.find('=')));
+  }
+  return keys;
+}
+
+TEST(SolutionCache, memory)
+{
+  const auto scen_filename = "./assets/random-32-32-10-random-1.scen";
+  const auto map_filename = "./assets/random-32-32-10.map";
+  const auto ins = Instance(scen_filename, map_filename, 10);
+  auto cache = SolutionCache(2);
+
+  auto additional_info = std::string();
+  auto solution = solve(ins, additional_info, 0, nullptr, nullptr, OBJ_NONE,
+                        0.001, &cache);
+  ASSERT_EQ(cache.miss_cnt, 1);
+
+  // the same query from another instance object
+  const auto ins_same = Instance(scen_filename, map_filename, 10);
+  auto solution_cached = solve(ins_same, additional_info, 0, nullptr, nullptr,
+                               OBJ_NONE, 0.001, &cache);
+  ASSERT_EQ(cache.hit_cnt, 1);
+  ASSERT_TRUE(is_feasible_solution(ins_same, solution_cached));
+  ASSERT_EQ(solution.size(), solution_cached.size());
+
+  // different objective, different number of agents
+  auto tmp = Solution();
+  ASSERT_FALSE(cache.find(ins, OBJ_MAKESPAN, tmp));
+  const auto ins_other = Instance(scen_filename, map_filename, 5);
+  ASSERT_FALSE(cache.find(ins_other, OBJ_NONE, tmp));
+
+  // eviction
+  const auto ins_a = Instance(scen_filename, map_filename, 3);
+  const auto ins_b = Instance(scen_filename, map_filename, 4);
+  solve(ins_a, additional_info, 0, nullptr, nullptr, OBJ_NONE, 0.001, &cache);
+  solve(ins_b, additional_info, 0, nullptr, nullptr, OBJ_NONE, 0.001, &cache);
+  ASSERT_EQ(cache.entries.size(), 2);
+  ASSERT_FALSE(cache.find(ins, OBJ_NONE, tmp));
+}
+
+TEST(SolutionCache, disk)
+{
+  const auto cache_dir =
+      (std::filesystem::temp_directory_path() / "lacam2_test_cache").string();
+  std::filesystem::remove_all(cache_dir);
+
+  const auto scen_filename = "./assets/random-32-32-10-random-1.scen";
+  const auto map_filename = "./assets/random-32-32-10.map";
+  const auto ins = Instance(scen_filename, map_filename, 10);
+  auto additional_info = std::string();
+  {
+    auto cache = SolutionCache(1, cache_dir);
+    solve(ins, additional_info, 0, nullptr, nullptr, OBJ_NONE, 0.001, &cache);
+  }
+
+  // new process, empty memory
+  auto cache = SolutionCache(1, cache_dir);
+  auto solution = Solution();
+  ASSERT_TRUE(cache.find(ins, OBJ_NONE, solution));
+  ASSERT_TRUE(is_feasible_solution(ins, solution));
+
+  // broken entry is rejected
+  auto ins_moved = Instance(scen_filename, map_filename, 10);
+  std::swap(ins_moved.goals[0], ins_moved.goals[1]);
+  cache.insert(ins_moved, OBJ_NONE, solution);
+  auto cache_reload = SolutionCache(1, cache_dir);
+  ASSERT_FALSE(cache_reload.find(ins_moved, OBJ_NONE, solution));
+
+  std::filesystem::remove_all(cache_dir);
+}
+
+TEST(SolutionCache, same_keys)
+{
+  // hits and misses log the same keys
+  const auto scen_filename = "./assets/random-32-32-10-random-1.scen";
+  const auto map_filename = "./assets/random-32-32-10.map";
+  const auto ins = Instance(scen_filename, map_filename, 10);
+  auto options = PlannerOptions();
+  for (auto k = 0; k < 2; ++k) {
+    if (k == 1) {
+      options.pibt_stats = true;
+      options.dist.mode = DIST_BOUNDED;
+    }
+    auto cache = SolutionCache(1);
+    auto info_miss = std::string();
+    solve(ins, info_miss, 0, nullptr, nullptr, OBJ_NONE, 0.001, &cache,
+          nullptr, nullptr, options);
+    auto info_hit = std::string();
+    solve(ins, info_hit, 0, nullptr, nullptr, OBJ_NONE, 0.001, &cache,
+          nullptr, nullptr, options);
+    ASSERT_EQ(cache.hit_cnt, 1);
+    ASSERT_NE(info_hit.find("cache_hit=1"), std::string::npos);
+    ASSERT_EQ(get_keys(info_hit), get_keys(info_miss));
+  }
+}